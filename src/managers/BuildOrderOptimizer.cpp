@@ -0,0 +1,199 @@
+#include "src/managers/BuildOrderOptimizer.h"
+#include <QDebug>
+
+void BuildOrderOptimizer::setLanes(bool separateFieldLane,
+                                   qint64 fieldLaneFreeAtMs,
+                                   qint64 centerLaneFreeAtMs) {
+  m_separateFieldLane = separateFieldLane;
+  if (separateFieldLane) {
+    m_initialLaneFreeAtMs[0] = fieldLaneFreeAtMs;
+    m_initialLaneFreeAtMs[1] = centerLaneFreeAtMs;
+  } else {
+    // Tek inşaatçı: ikisinden geç olanı boşaldığında başlar
+    m_initialLaneFreeAtMs[0] = qMax(fieldLaneFreeAtMs, centerLaneFreeAtMs);
+    m_initialLaneFreeAtMs[1] = m_initialLaneFreeAtMs[0];
+  }
+}
+
+double BuildOrderOptimizer::stockAt(const SimState &state, int r,
+                                    qint64 atMs) const {
+  auto res = static_cast<ResourceSnapshot::Resource>(r);
+  double stock = state.stock[r] + m_resources->production(res) *
+                                      (atMs - state.stockAtMs) / 3600000.0;
+  return qMin<double>(m_resources->capacity(res), stock);
+}
+
+qint64 BuildOrderOptimizer::place(SimState &state, const Step &step) const {
+  int lane = m_separateFieldLane && !step.field ? 1 : 0;
+  qint64 earliest = qMax(state.lastStartMs, state.laneFreeAtMs[lane]);
+
+  // Stoğu en erken başlangıca taşı, sonra eksik kaynağın birikmesini bekle
+  qint64 waitMs = 0;
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    auto res = static_cast<ResourceSnapshot::Resource>(r);
+    if (step.cost[r] > m_resources->capacity(res)) {
+      return -1;
+    }
+    double missing = step.cost[r] - stockAt(state, r, earliest);
+    if (missing <= 0) {
+      continue;
+    }
+    int production = m_resources->production(res);
+    if (production <= 0) {
+      return -1;
+    }
+    waitMs = qMax(waitMs,
+                  static_cast<qint64>(missing * 3600000.0 / production) + 1);
+  }
+
+  qint64 start = earliest + waitMs;
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    state.stock[r] = qMax(0.0, stockAt(state, r, start) - step.cost[r]);
+  }
+  state.stockAtMs = start;
+  state.lastStartMs = start;
+  state.laneFreeAtMs[lane] = start + step.seconds * 1000LL;
+  state.makespanMs = qMax(state.makespanMs, state.laneFreeAtMs[lane]);
+  return start;
+}
+
+qint64 BuildOrderOptimizer::lowerBound(const SimState &state,
+                                       const QList<bool> &used,
+                                       const QList<Step> &steps) const {
+  // Şeritler boşta beklemeden kalan adımları art arda yapsa bile bitiş bu
+  qint64 remaining[2] = {};
+  for (int i = 0; i < steps.size(); ++i) {
+    if (!used[i]) {
+      int lane = m_separateFieldLane && !steps[i].field ? 1 : 0;
+      remaining[lane] += steps[i].seconds * 1000LL;
+    }
+  }
+  return qMax(state.makespanMs,
+              qMax(state.laneFreeAtMs[0] + remaining[0],
+                   state.laneFreeAtMs[1] + remaining[1]));
+}
+
+void BuildOrderOptimizer::search(const SimState &state, QList<int> &order,
+                                 QList<bool> &used, const QList<Step> &steps) {
+  if (++m_nodes > MAX_NODES) {
+    return;
+  }
+
+  if (order.size() == steps.size()) {
+    if (state.makespanMs < m_bestMakespanMs) {
+      m_bestMakespanMs = state.makespanMs;
+      m_bestOrder = order;
+    }
+    return;
+  }
+
+  if (lowerBound(state, used, steps) >= m_bestMakespanMs) {
+    return;
+  }
+
+  for (int i = 0; i < steps.size(); ++i) {
+    if (used[i]) {
+      continue;
+    }
+
+    // Aynı slotun seviyeleri sırayla
+    bool blocked = false;
+    for (int j = 0; j < i; ++j) {
+      if (!used[j] && steps[j].slotId == steps[i].slotId) {
+        blocked = true;
+        break;
+      }
+    }
+    if (blocked) {
+      continue;
+    }
+
+    SimState next = state;
+    qint64 start = place(next, steps[i]);
+    // Öncelik kısıtı: hiçbir adım sade öncelik sırasındakinden fazla
+    // gecikmesin
+    if (start < 0 ||
+        start > m_baselineStartMs[i] + PRIORITY_SLACK_SECONDS * 1000) {
+      continue;
+    }
+
+    used[i] = true;
+    order.append(i);
+    search(next, order, used, steps);
+    order.removeLast();
+    used[i] = false;
+  }
+}
+
+QList<BuildOrderOptimizer::PlannedStep>
+BuildOrderOptimizer::plan(const QList<Step> &steps,
+                          const ResourceSnapshot &resources, qint64 nowMs) {
+  m_resources = &resources;
+  m_nodes = 0;
+
+  SimState initial;
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    initial.stock[r] =
+        resources.projected(static_cast<ResourceSnapshot::Resource>(r), nowMs);
+  }
+  initial.stockAtMs = nowMs;
+  initial.lastStartMs = nowMs;
+  initial.laneFreeAtMs[0] = qMax(nowMs, m_initialLaneFreeAtMs[0]);
+  initial.laneFreeAtMs[1] = qMax(nowMs, m_initialLaneFreeAtMs[1]);
+  initial.makespanMs = nowMs;
+
+  // Sade öncelik sırası: hem kısıtların referansı hem başlangıç çözümü.
+  // Öngörülemeyen ilk adımdan sonrası optimize edilmez.
+  QList<Step> head;
+  m_baselineStartMs.clear();
+  SimState baseline = initial;
+  for (const Step &step : steps) {
+    if (head.size() >= MAX_OPTIMIZED_STEPS) {
+      break;
+    }
+    qint64 start = place(baseline, step);
+    if (start < 0) {
+      break;
+    }
+    head.append(step);
+    m_baselineStartMs.append(start);
+  }
+
+  m_bestOrder.clear();
+  for (int i = 0; i < head.size(); ++i) {
+    m_bestOrder.append(i);
+  }
+  m_bestMakespanMs = baseline.makespanMs;
+  qint64 baselineMakespanMs = baseline.makespanMs;
+
+  if (head.size() > 1) {
+    QList<int> order;
+    QList<bool> used(head.size(), false);
+    search(initial, order, used, head);
+  }
+
+  if (m_bestMakespanMs < baselineMakespanMs) {
+    qDebug() << "[BUILD_OPT] Reordered" << head.size() << "steps, makespan"
+             << (baselineMakespanMs - nowMs) / 1000 << "s ->"
+             << (m_bestMakespanMs - nowMs) / 1000 << "s (" << m_nodes
+             << "nodes)";
+  }
+
+  // Sonuç: optimize edilen baş + kalan adımlar öncelik sırasıyla
+  QList<PlannedStep> result;
+  SimState state = initial;
+  bool stuck = false;
+  for (int i = 0; i < steps.size(); ++i) {
+    PlannedStep planned;
+    planned.step = i < head.size() ? head[m_bestOrder[i]] : steps[i];
+    if (!stuck) {
+      planned.startMs = place(state, planned.step);
+      stuck = planned.startMs < 0;
+      if (!stuck) {
+        planned.endMs = planned.startMs + planned.step.seconds * 1000LL;
+      }
+    }
+    result.append(planned);
+  }
+  return result;
+}
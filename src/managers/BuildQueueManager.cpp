@@ -1,11 +1,21 @@
 #include "src/managers/BuildQueueManager.h"
+#include "src/models/BuildingData.h"
+#include "src/models/ResourceSnapshot.h"
+#include "src/network/RefreshPlanner.h"
 #include "src/network/TravianDataFetcher.h"
+#include <QDateTime>
 #include <QDebug>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QSet>
 
-BuildQueueManager::BuildQueueManager(QObject *parent) : QObject(parent) {}
+BuildQueueManager::BuildQueueManager(QObject *parent) : QObject(parent) {
+  // 1-second tick for construction handoffs (only runs while one is pending)
+  m_tickTimer = new QTimer(this);
+  m_tickTimer->setInterval(1000);
+  connect(m_tickTimer, &QTimer::timeout, this, &BuildQueueManager::onTimer);
+}
 
 QJsonObject BuildQueueManager::BuildTask::toJson() const {
   QJsonObject obj;
@@ -15,6 +25,9 @@ QJsonObject BuildQueueManager::BuildTask::toJson() const {
   obj["targetLevel"] = targetLevel;
   obj["buildingName"] = buildingName;
   obj["priority"] = priority;
+  if (autoPlanned) {
+    obj["auto"] = true;
+  }
   return obj;
 }
 
@@ -27,6 +40,7 @@ BuildQueueManager::BuildTask::fromJson(const QJsonObject &obj) {
   task.targetLevel = obj["targetLevel"].toInt();
   task.buildingName = obj["buildingName"].toString();
   task.priority = obj["priority"].toInt();
+  task.autoPlanned = obj["auto"].toBool(false);
   return task;
 }
 
@@ -113,6 +127,63 @@ void BuildQueueManager::addTask(const BuildTask &task) {
     saveQueue(m_queueFilePath);
   }
 
+  if (m_lastVillageData.contains(task.villageId)) {
+    planVillage(task.villageId, m_lastVillageData[task.villageId]);
+  }
+
+  emit queueChanged();
+}
+
+void BuildQueueManager::replaceAutoTasks(int villageId,
+                                         const QList<BuildTask> &tasks) {
+  QList<BuildTask> &queue = m_queues[villageId];
+
+  // Değişiklik yoksa dokunma (kayıt ve yeniden planlama gereksiz)
+  QList<BuildTask> current;
+  for (const BuildTask &task : queue) {
+    if (task.autoPlanned) {
+      current.append(task);
+    }
+  }
+  bool same = current.size() == tasks.size();
+  for (int i = 0; same && i < tasks.size(); ++i) {
+    same = current[i].slotId == tasks[i].slotId &&
+           current[i].targetLevel == tasks[i].targetLevel;
+  }
+  if (same) {
+    if (queue.isEmpty()) {
+      m_queues.remove(villageId);
+    }
+    return;
+  }
+
+  // Otomatik görevler elle eklenenlerin arkasında kalır
+  queue.erase(std::remove_if(queue.begin(), queue.end(),
+                             [](const BuildTask &task) {
+                               return task.autoPlanned;
+                             }),
+              queue.end());
+  int priority = 0;
+  for (const BuildTask &task : queue) {
+    priority = qMax(priority, task.priority);
+  }
+  for (BuildTask task : tasks) {
+    task.autoPlanned = true;
+    task.priority = ++priority;
+    queue.append(task);
+  }
+  if (queue.isEmpty()) {
+    m_queues.remove(villageId);
+  }
+
+  if (!m_queueFilePath.isEmpty()) {
+    saveQueue(m_queueFilePath);
+  }
+
+  if (m_lastVillageData.contains(villageId)) {
+    planVillage(villageId, m_lastVillageData[villageId]);
+  }
+
   emit queueChanged();
 }
 
@@ -133,6 +204,10 @@ void BuildQueueManager::removeTask(int villageId, int index) {
       saveQueue(m_queueFilePath);
     }
 
+    if (m_lastVillageData.contains(villageId)) {
+      planVillage(villageId, m_lastVillageData[villageId]);
+    }
+
     emit queueChanged();
   }
 }
@@ -162,35 +237,172 @@ int BuildQueueManager::totalTaskCount() const {
   return count;
 }
 
-bool BuildQueueManager::isBuilderFree(const QVariantMap &villageData) const {
+QList<BuildQueueManager::ConstructionEntry>
+BuildQueueManager::constructionEntries(const QVariantMap &villageData) const {
   QVariantMap dorf1Data = villageData["dorf1"].toMap();
-  QVariantList constructionQueue = dorf1Data["constructionQueue"].toList();
-  return constructionQueue.isEmpty();
+
+  QStringList fieldNames;
+  const QVariantList resourceFields = dorf1Data["resourceFields"].toList();
+  for (const QVariant &field : resourceFields) {
+    QString name = field.toMap()["name"].toString().trimmed();
+    if (!name.isEmpty() && !fieldNames.contains(name)) {
+      fieldNames.append(name);
+    }
+  }
+
+  // Sayfa önceki döngüden kalmış olabilir - geçen süreyi düş. fetchedAt
+  // sayfa sürelerinin sunucu saatine hizalı taban anıdır
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  qint64 fetchedAt = dorf1Data["fetchedAt"].toLongLong();
+  if (fetchedAt <= 0) {
+    fetchedAt = now;
+  }
+
+  QList<ConstructionEntry> entries;
+  const QVariantList constructionQueue =
+      dorf1Data["constructionQueue"].toList();
+  for (const QVariant &item : constructionQueue) {
+    QVariantMap itemMap = item.toMap();
+    ConstructionEntry entry;
+    entry.name = itemMap["buildingName"].toString().trimmed();
+    for (const QString &fieldName : fieldNames) {
+      if (entry.name.startsWith(fieldName, Qt::CaseInsensitive)) {
+        entry.field = true;
+        break;
+      }
+    }
+    int seconds =
+        RefreshPlanner::parseDuration(itemMap["remainingTime"].toString());
+    entry.endsAtMs = fetchedAt + seconds * 1000LL;
+    entry.secondsLeft =
+        static_cast<int>(qMax<qint64>(0, entry.endsAtMs - now) / 1000);
+    entries.append(entry);
+  }
+  return entries;
+}
+
+bool BuildQueueManager::hasFreeBuilderSlot(const QVariantMap &villageData,
+                                           bool field) const {
+  int fields = 0;
+  int center = 0;
+  const QList<ConstructionEntry> entries = constructionEntries(villageData);
+  for (const ConstructionEntry &entry : entries) {
+    if (entry.secondsLeft <= 0) {
+      continue; // Bitmiş (sayfa eski)
+    }
+    entry.field ? fields++ : center++;
+  }
+
+  // Romalılar: kaynak alanları ve köy merkezi için ayrı inşaatçı. Diğer
+  // halklar: tek inşaatçı. Plus bunların üstüne bir bekleyen emir ekler.
+  bool slotFree;
+  int waiting;
+  if (isRoman(villageData)) {
+    slotFree = (field ? fields : center) == 0;
+    waiting = qMax(0, fields - 1) + qMax(0, center - 1);
+  } else {
+    slotFree = fields + center == 0;
+    waiting = qMax(0, fields + center - 1);
+  }
+  return slotFree || waiting < (m_plusAccount ? 1 : 0);
+}
+
+bool BuildQueueManager::isRoman(const QVariantMap &villageData) const {
+  return villageData["dorf1"].toMap()["tribe"].toInt() == 1;
 }
 
 int BuildQueueManager::getBuilderRemainingTime(
     const QVariantMap &villageData) const {
+  // En erken biten inşaat bir inşaatçıyı (ya da bekleyen emir yerini) boşaltır
+  int seconds = -1;
+  const QList<ConstructionEntry> entries = constructionEntries(villageData);
+  for (const ConstructionEntry &entry : entries) {
+    if (seconds < 0 || entry.secondsLeft < seconds) {
+      seconds = entry.secondsLeft;
+    }
+  }
+  return qMax(0, seconds);
+}
+
+void BuildQueueManager::reserveConstruction(QVariantMap &villageData,
+                                            const BuildTask &task,
+                                            int currentLevel) const {
   QVariantMap dorf1Data = villageData["dorf1"].toMap();
-  QVariantList constructionQueue = dorf1Data["constructionQueue"].toList();
 
-  if (constructionQueue.isEmpty()) {
-    return 0;
+  // Harcanan kaynağı düş ki aynı döngüdeki sonraki görev doğru kontrol edilsin
+  const int *cost = BuildingData::cost(getGid(villageData, task.slotId),
+                                       currentLevel + 1);
+  if (cost) {
+    const char *stockKeys[] = {"lumber", "clay", "iron", "crop"};
+    for (int r = 0; r < 4; ++r) {
+      int stock = dorf1Data[stockKeys[r]].toString().remove('.').toInt();
+      dorf1Data[stockKeys[r]] = QString::number(qMax(0, stock - cost[r]));
+    }
   }
 
-  QVariantMap firstItem = constructionQueue.first().toMap();
-  QString remainingTime = firstItem["remainingTime"].toString();
+  // Slotu dolu göstermek için kuyruğa geçici satır (süre sadece işaret)
+  QString name = task.buildingName;
+  const QVariantList resourceFields = dorf1Data["resourceFields"].toList();
+  for (const QVariant &field : resourceFields) {
+    QVariantMap fieldMap = field.toMap();
+    if (fieldMap["slotId"].toInt() == task.slotId) {
+      name = fieldMap["name"].toString().trimmed();
+    }
+  }
+  const QVariantList buildings =
+      villageData["dorf2"].toMap()["buildings"].toList();
+  for (const QVariant &building : buildings) {
+    QVariantMap buildingMap = building.toMap();
+    if (buildingMap["slotId"].toInt() == task.slotId) {
+      name = buildingMap["name"].toString().trimmed();
+    }
+  }
+
+  QVariantMap entry;
+  entry["buildingName"] = name;
+  entry["level"] = currentLevel + 1;
+  entry["remainingTime"] = "99:00:00";
+  QVariantList constructionQueue = dorf1Data["constructionQueue"].toList();
+  constructionQueue.append(entry);
+  dorf1Data["constructionQueue"] = constructionQueue;
 
-  QStringList parts = remainingTime.split(':');
-  int seconds = 0;
+  villageData["dorf1"] = dorf1Data;
+}
 
-  if (parts.size() == 3) {
-    seconds =
-        parts[0].toInt() * 3600 + parts[1].toInt() * 60 + parts[2].toInt();
-  } else if (parts.size() == 2) {
-    seconds = parts[0].toInt() * 60 + parts[1].toInt();
+bool BuildQueueManager::mayBeUnderConstruction(const QVariantMap &villageData,
+                                               int slotId) const {
+  QString slotName;
+  const QVariantList resourceFields =
+      villageData["dorf1"].toMap()["resourceFields"].toList();
+  for (const QVariant &field : resourceFields) {
+    QVariantMap fieldMap = field.toMap();
+    if (fieldMap["slotId"].toInt() == slotId) {
+      slotName = fieldMap["name"].toString().trimmed();
+    }
+  }
+  const QVariantList buildings =
+      villageData["dorf2"].toMap()["buildings"].toList();
+  for (const QVariant &building : buildings) {
+    QVariantMap buildingMap = building.toMap();
+    if (buildingMap["slotId"].toInt() == slotId) {
+      slotName = buildingMap["name"].toString().trimmed();
+    }
   }
 
-  return seconds;
+  if (slotName.isEmpty()) {
+    return true; // Bilinmiyor: güvenli tarafta kal
+  }
+
+  const QVariantList constructionQueue =
+      villageData["dorf1"].toMap()["constructionQueue"].toList();
+  for (const QVariant &item : constructionQueue) {
+    QString name = item.toMap()["buildingName"].toString().trimmed();
+    if (name.startsWith(slotName, Qt::CaseInsensitive) ||
+        slotName.startsWith(name, Qt::CaseInsensitive)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 int BuildQueueManager::getCurrentLevel(const QVariantMap &villageData,
@@ -218,18 +430,184 @@ int BuildQueueManager::getCurrentLevel(const QVariantMap &villageData,
   return 0;
 }
 
+int BuildQueueManager::getGid(const QVariantMap &villageData,
+                              int slotId) const {
+  const QVariantList resourceFields =
+      villageData["dorf1"].toMap()["resourceFields"].toList();
+  for (const QVariant &field : resourceFields) {
+    QVariantMap fieldMap = field.toMap();
+    if (fieldMap["slotId"].toInt() == slotId) {
+      return fieldMap["gid"].toInt();
+    }
+  }
+
+  const QVariantList buildings =
+      villageData["dorf2"].toMap()["buildings"].toList();
+  for (const QVariant &building : buildings) {
+    QVariantMap buildingMap = building.toMap();
+    if (buildingMap["slotId"].toInt() == slotId) {
+      return buildingMap["gid"].toInt();
+    }
+  }
+
+  return 0;
+}
+
+ResourceSnapshot
+BuildQueueManager::resources(const QVariantMap &villageData) const {
+  if (!m_fetcher) {
+    return ResourceSnapshot::fromVillageData(villageData);
+  }
+  return m_fetcher->villageStore().resources(villageData["villageId"].toInt());
+}
+
 bool BuildQueueManager::canAffordBuilding(const QVariantMap &villageData,
                                           int slotId, int currentLevel) const {
-  Q_UNUSED(slotId);
-  Q_UNUSED(currentLevel);
-  QVariantMap dorf1Data = villageData["dorf1"].toMap();
+  return secondsUntilAffordable(villageData, slotId, currentLevel) == 0;
+}
+
+int BuildQueueManager::secondsUntilAffordable(const QVariantMap &villageData,
+                                              int slotId,
+                                              int currentLevel) const {
+  ResourceSnapshot snapshot = resources(villageData);
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  int gid = getGid(villageData, slotId);
+  const int *cost = BuildingData::cost(gid, currentLevel + 1);
+  if (!cost) {
+    // Tabloda olmayan bina (ya da boş slot): eski eşik, her kaynaktan 100
+    static const int fallbackCost[ResourceSnapshot::ResourceCount] = {
+        100, 100, 100, 100};
+    return snapshot.secondsUntilAffordable(fallbackCost, now);
+  }
+
+  // Yeni seviyenin tahıl tüketimini net tahıl üretimi karşılamalı; tarlalar
+  // hariç (tüketimleri kendi üretimlerinden düşer)
+  int upkeep = BuildingData::upkeep(gid, currentLevel + 1);
+  if (gid != 4 && upkeep > 0 &&
+      snapshot.production(ResourceSnapshot::Crop) < upkeep) {
+    return -1;
+  }
+
+  return snapshot.secondsUntilAffordable(cost, now);
+}
+
+int BuildQueueManager::secondsUntilNextTaskAffordable(
+    int villageId, const QVariantMap &villageData) const {
+  const QList<BuildTask> tasks = orderedTasks(villageId);
+  for (const BuildTask &task : tasks) {
+    int currentLevel = getCurrentLevel(villageData, task.slotId);
+    if (currentLevel >= task.targetLevel) {
+      continue;
+    }
+    return secondsUntilAffordable(villageData, task.slotId, currentLevel);
+  }
+  return -1;
+}
+
+void BuildQueueManager::planVillage(int villageId,
+                                    const QVariantMap &villageData) {
+  const QList<BuildTask> tasks = m_queues.value(villageId);
+  if (tasks.isEmpty()) {
+    if (m_plans.remove(villageId) > 0) {
+      emit timelineChanged();
+    }
+    return;
+  }
+
+  int mainBuildingLevel = 1;
+  const QVariantList buildings =
+      villageData["dorf2"].toMap()["buildings"].toList();
+  for (const QVariant &building : buildings) {
+    QVariantMap buildingMap = building.toMap();
+    if (buildingMap["gid"].toInt() == 15) {
+      mainBuildingLevel = qMax(1, buildingMap["level"].toInt());
+    }
+  }
 
-  int lumber = dorf1Data["lumber"].toString().remove('.').toInt();
-  int clay = dorf1Data["clay"].toString().remove('.').toInt();
-  int iron = dorf1Data["iron"].toString().remove('.').toInt();
-  int crop = dorf1Data["crop"].toString().remove('.').toInt();
+  // Her görev seviye başına bir adım (öncelik sırasında)
+  QList<BuildOrderOptimizer::Step> steps;
+  for (int i = 0; i < tasks.size(); ++i) {
+    const BuildTask &task = tasks[i];
+    int gid = getGid(villageData, task.slotId);
+    int currentLevel = getCurrentLevel(villageData, task.slotId);
+    for (int level = currentLevel + 1; level <= task.targetLevel; ++level) {
+      BuildOrderOptimizer::Step step;
+      step.taskIndex = i;
+      step.slotId = task.slotId;
+      step.level = level;
+      step.field = isResourceField(task.slotId);
+      step.buildingName = task.buildingName;
+
+      const int *cost = BuildingData::cost(gid, level);
+      for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+        step.cost[r] = cost ? cost[r] : 100; // Bilinmiyorsa eski eşik
+      }
+      step.seconds = qMax(0, BuildingData::buildSeconds(
+                                 gid, level, mainBuildingLevel, m_serverSpeed));
+      steps.append(step);
+    }
+  }
+
+  // Şeritlerin boşalma zamanı: tipindeki en geç biten inşaat
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  qint64 fieldFreeAt = now;
+  qint64 centerFreeAt = now;
+  const QList<ConstructionEntry> entries = constructionEntries(villageData);
+  for (const ConstructionEntry &entry : entries) {
+    qint64 endAt = qMax(now, entry.endsAtMs);
+    qint64 &laneFreeAt = entry.field ? fieldFreeAt : centerFreeAt;
+    laneFreeAt = qMax(laneFreeAt, endAt);
+  }
+
+  BuildOrderOptimizer optimizer;
+  optimizer.setLanes(isRoman(villageData), fieldFreeAt, centerFreeAt);
+  m_plans[villageId] = optimizer.plan(steps, resources(villageData), now);
+  emit timelineChanged();
+}
+
+QList<BuildQueueManager::BuildTask>
+BuildQueueManager::orderedTasks(int villageId) const {
+  const QList<BuildTask> tasks = m_queues.value(villageId);
+  auto plan = m_plans.constFind(villageId);
+  if (plan == m_plans.constEnd()) {
+    return tasks;
+  }
+
+  // Planın ilk adımına göre görev sırası; plan eskiyse kalanlar öncelikle
+  QList<BuildTask> ordered;
+  QSet<int> seen;
+  for (const BuildOrderOptimizer::PlannedStep &planned : plan.value()) {
+    int index = planned.step.taskIndex;
+    if (index < tasks.size() && !seen.contains(index) &&
+        tasks[index].slotId == planned.step.slotId) {
+      seen.insert(index);
+      ordered.append(tasks[index]);
+    }
+  }
+  for (int i = 0; i < tasks.size(); ++i) {
+    if (!seen.contains(i)) {
+      ordered.append(tasks[i]);
+    }
+  }
+  return ordered;
+}
 
-  return (lumber >= 100 && clay >= 100 && iron >= 100 && crop >= 100);
+QVariantList BuildQueueManager::timeline() const {
+  QVariantList result;
+  for (auto it = m_plans.constBegin(); it != m_plans.constEnd(); ++it) {
+    for (const BuildOrderOptimizer::PlannedStep &planned : it.value()) {
+      QVariantMap item;
+      item["villageId"] = it.key();
+      item["slotId"] = planned.step.slotId;
+      item["buildingName"] = planned.step.buildingName;
+      item["level"] = planned.step.level;
+      item["startAt"] = planned.startMs;
+      item["endAt"] = planned.endMs;
+      result.append(item);
+    }
+  }
+  return result;
 }
 
 void BuildQueueManager::processQueue(TravianDataFetcher *fetcher,
@@ -246,54 +624,299 @@ void BuildQueueManager::processQueue(TravianDataFetcher *fetcher,
       continue;
     }
 
-    QVariantMap villageData = allData[villageKey].toMap();
-    QList<BuildTask> &tasks = m_queues[villageId];
+    processVillage(fetcher, villageId, allData[villageKey].toMap());
+  }
+}
+
+void BuildQueueManager::processVillage(TravianDataFetcher *fetcher,
+                                       int villageId,
+                                       const QVariantMap &villageData) {
+  if (!fetcher || !m_queues.contains(villageId)) {
+    return;
+  }
 
-    if (tasks.isEmpty()) {
+  if (m_queues[villageId].isEmpty()) {
+    return;
+  }
+
+  m_fetcher = fetcher;
+  m_lastVillageData[villageId] = villageData;
+
+  // Son yükseltmeden önce çekilmiş veri inşaatçıyı boş gösterebilir.
+  // fetchedAt sunucu saniyesine hizalıdır (en fazla 1 sn erken); yükseltme
+  // yanıtından işlenen sayfa bu yüzden 1 sn toleransla kabul edilir
+  qint64 fetchedAt = villageData["dorf1"].toMap()["fetchedAt"].toLongLong();
+  if (fetchedAt > 0 &&
+      fetchedAt + 1000 < m_upgradeSentAtMs.value(villageId)) {
+    qDebug() << "[BUILD_QUEUE] Village" << villageId
+             << "data predates last upgrade request, waiting for refresh";
+    return;
+  }
+
+  // Hedefe ulaşmış görevleri kuyruktan çıkar
+  const QList<BuildTask> tasks = m_queues[villageId];
+  for (const BuildTask &task : tasks) {
+    if (getCurrentLevel(villageData, task.slotId) < task.targetLevel) {
       continue;
     }
-
-    // Check if builder is free for this village
-    if (!isBuilderFree(villageData)) {
-      int remainingSec = getBuilderRemainingTime(villageData);
-      emit builderBusy(villageId, remainingSec);
-      continue; // Try next village instead of returning
-    }
-
-    // Process first task in this village's queue
-    for (int i = 0; i < tasks.size(); ++i) {
-      const BuildTask &task = tasks[i];
-
-      // Check current level
-      int currentLevel = getCurrentLevel(villageData, task.slotId);
-      if (currentLevel >= task.targetLevel) {
-        int vid = task.villageId;
-        int sid = task.slotId;
-        tasks.removeAt(i);
-        if (tasks.isEmpty()) {
-          m_queues.remove(villageId);
-        }
-        if (!m_queueFilePath.isEmpty()) {
-          saveQueue(m_queueFilePath);
-        }
-        emit queueChanged();
-        emit taskCompleted(vid, sid);
-        i--;
-        continue;
+    QList<BuildTask> &queue = m_queues[villageId];
+    for (int i = 0; i < queue.size(); ++i) {
+      if (queue[i].slotId == task.slotId &&
+          queue[i].targetLevel == task.targetLevel) {
+        queue.removeAt(i);
+        break;
       }
+    }
+    if (!m_queueFilePath.isEmpty()) {
+      saveQueue(m_queueFilePath);
+    }
+    emit queueChanged();
+    emit taskCompleted(task.villageId, task.slotId);
+  }
+  if (m_queues[villageId].isEmpty()) {
+    m_queues.remove(villageId);
+    m_handoffs.remove(villageId);
+    planVillage(villageId, villageData);
+    return;
+  }
 
-      // Check resources
-      if (!canAffordBuilding(villageData, task.slotId, currentLevel)) {
-        emit insufficientResources(villageId, task.buildingName);
-        break; // Try next village
-      }
+  // Öncelikler kısıt olarak kalır; ucuz bir görev öndekileri geciktirmeden
+  // önce başlayabiliyorsa plan onu öne alır
+  planVillage(villageId, villageData);
+
+  // Boş inşaatçı slotu olduğu sürece, slot tipine uyan görevleri sırayla
+  // başlat. Başlatılan her görev kaynağı ve slotu çalışma kopyasında ayırır.
+  QVariantMap working = villageData;
+  int started = 0;
+  bool blockedBySlot = false;
+  const QList<BuildTask> pending = orderedTasks(villageId);
+  for (const BuildTask &task : pending) {
+    int currentLevel = getCurrentLevel(working, task.slotId);
+    if (currentLevel >= task.targetLevel) {
+      continue;
+    }
 
-      // Start upgrade for this village
-      fetcher->upgradeBuilding(task.villageId, task.slotId);
-      emit taskStarted(task.villageId, task.slotId, task.buildingName);
+    // Önceki yükseltme isteği yanıtlanmadı: seviye verisi henüz eski
+    if (isUpgradeInFlight(villageId, task.slotId)) {
+      continue;
+    }
+
+    if (!hasFreeBuilderSlot(working, isResourceField(task.slotId))) {
+      blockedBySlot = true;
+      continue; // Diğer tipteki slot boş olabilir
+    }
 
-      // Only one upgrade per village per cycle
+    // Aynı yapı zaten inşa ediliyorsa eski seviyeyle tekrar gönderme
+    if (mayBeUnderConstruction(working, task.slotId)) {
+      continue;
+    }
+
+    // Check resources
+    if (!canAffordBuilding(working, task.slotId, currentLevel)) {
+      emit insufficientResources(villageId, task.buildingName);
       break;
     }
+
+    startUpgrade(fetcher, task);
+    reserveConstruction(working, task, currentLevel);
+    started++;
+  }
+
+  if (started > 0) {
+    qDebug() << "[BUILD_QUEUE] Village" << villageId << "started" << started
+             << "upgrade(s)";
+    return;
+  }
+
+  // Hiçbir görev başlayamadı çünkü slotlar dolu: ilk boşalmada el değiştir
+  if (blockedBySlot) {
+    int remainingSec = getBuilderRemainingTime(villageData);
+    m_builderFreeAtMs[villageId] =
+        QDateTime::currentMSecsSinceEpoch() + remainingSec * 1000LL;
+    scheduleHandoff(villageId, villageData);
+    emit builderBusy(villageId, remainingSec);
+  } else {
+    m_handoffs.remove(villageId);
+  }
+}
+
+void BuildQueueManager::scheduleHandoff(int villageId,
+                                        const QVariantMap &villageData) {
+  // İlk boşalacak slotun tipi (Romalılarda alan/merkez ayrı)
+  bool anyType = !isRoman(villageData) || m_plusAccount;
+  bool freesField = false;
+  qint64 earliestEndMs = -1;
+  const QList<ConstructionEntry> entries = constructionEntries(villageData);
+  for (const ConstructionEntry &entry : entries) {
+    if (earliestEndMs < 0 || entry.endsAtMs < earliestEndMs) {
+      earliestEndMs = entry.endsAtMs;
+      freesField = entry.field;
+    }
+  }
+
+  // Sıradaki görev: processVillage ile aynı sırada, hedefe ulaşmamış ve
+  // boşalacak slota uyan ilk görev
+  int slotId = -1;
+  const QList<BuildTask> tasks = orderedTasks(villageId);
+  for (const BuildTask &task : tasks) {
+    if (getCurrentLevel(villageData, task.slotId) >= task.targetLevel) {
+      continue;
+    }
+    if (anyType || isResourceField(task.slotId) == freesField) {
+      slotId = task.slotId;
+      break;
+    }
+  }
+
+  if (slotId < 0 || mayBeUnderConstruction(villageData, slotId)) {
+    m_handoffs.remove(villageId);
+    return;
+  }
+
+  Handoff handoff;
+  handoff.slotId = slotId;
+  handoff.dueMs = earliestEndMs + HANDOFF_MARGIN_MS;
+  // Aynı inşaat için sayfa zaten çekildiyse tekrar çekme
+  auto existing = m_handoffs.constFind(villageId);
+  if (existing != m_handoffs.constEnd() && existing->slotId == slotId) {
+    handoff.prefetched = existing->prefetched;
+  }
+  m_handoffs[villageId] = handoff;
+
+  qDebug() << "[BUILD_QUEUE] Village" << villageId << "handoff to slot"
+           << slotId << "in"
+           << handoff.dueMs - QDateTime::currentMSecsSinceEpoch() << "ms";
+
+  if (!m_tickTimer->isActive()) {
+    m_tickTimer->start();
+  }
+  armPreciseHandoff();
+}
+
+void BuildQueueManager::armPreciseHandoff() {
+  // Saniyelik tik inşaat bitişini 1 sn'ye kadar kaçırabilir; bir sonraki
+  // tikten önce düşen el değiştirme için ayrıca tam zamanlı tek atış kur
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  for (auto it = m_handoffs.constBegin(); it != m_handoffs.constEnd(); ++it) {
+    qint64 delay = it->dueMs - now;
+    if (delay >= 0 && delay < m_tickTimer->interval()) {
+      QTimer::singleShot(static_cast<int>(delay), Qt::PreciseTimer, this,
+                         &BuildQueueManager::onTimer);
+    }
+  }
+}
+
+void BuildQueueManager::onTimer() {
+  QList<QPair<int, int>> due;
+
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  for (auto it = m_handoffs.begin(); it != m_handoffs.end();) {
+    Handoff &handoff = it.value();
+
+    if (!handoff.prefetched && m_fetcher &&
+        handoff.dueMs - now <=
+            PREFETCH_LEAD_SECONDS * 1000LL + HANDOFF_MARGIN_MS) {
+      handoff.prefetched = true;
+      m_fetcher->prefetchBuildPage(it.key(), handoff.slotId);
+    }
+
+    if (now >= handoff.dueMs) {
+      due.append(qMakePair(it.key(), handoff.slotId));
+      it = m_handoffs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (m_handoffs.isEmpty()) {
+    m_tickTimer->stop();
+  } else {
+    armPreciseHandoff();
+  }
+
+  for (const auto &pair : due) {
+    runHandoff(pair.first, pair.second);
+  }
+}
+
+void BuildQueueManager::runHandoff(int villageId, int slotId) {
+  if (!m_fetcher || m_queues.value(villageId).isEmpty()) {
+    return;
+  }
+
+  // Görev bu arada kuyruktan çıktıysa sıradaki görev yenilemeyle ele alınır
+  const QVariantMap villageData = m_lastVillageData.value(villageId);
+  const QList<BuildTask> tasks = m_queues.value(villageId);
+  for (const BuildTask &task : tasks) {
+    int currentLevel = getCurrentLevel(villageData, task.slotId);
+    if (currentLevel >= task.targetLevel) {
+      continue;
+    }
+    if (task.slotId != slotId) {
+      continue;
+    }
+
+    if (isUpgradeInFlight(villageId, slotId) ||
+        !hasFreeBuilderSlot(villageData, isResourceField(slotId))) {
+      return;
+    }
+
+    if (!canAffordBuilding(villageData, task.slotId, currentLevel)) {
+      emit insufficientResources(villageId, task.buildingName);
+      return;
+    }
+
+    qDebug() << "[BUILD_QUEUE] Construction finished in village" << villageId
+             << "- handing builder to" << task.buildingName;
+    startUpgrade(m_fetcher, task);
+    return;
+  }
+}
+
+void BuildQueueManager::startUpgrade(TravianDataFetcher *fetcher,
+                                     const BuildTask &task) {
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  // İnşaatçının boşta kaldığı süre (önceki inşaatın bitişinden bu yana)
+  auto freeAt = m_builderFreeAtMs.find(task.villageId);
+  if (freeAt != m_builderFreeAtMs.end()) {
+    qint64 idleSeconds = qMax<qint64>(0, (now - freeAt.value()) / 1000);
+    IdleStats &stats = m_idleStats[task.villageId];
+    stats.totalIdleSeconds += idleSeconds;
+    stats.starts++;
+    qDebug() << "[BUILD_QUEUE] Village" << task.villageId << "builder idle for"
+             << idleSeconds << "s (avg"
+             << stats.totalIdleSeconds / stats.starts << "s over"
+             << stats.starts << "starts)";
+    m_builderFreeAtMs.erase(freeAt);
+  }
+
+  m_upgradeSentAtMs[task.villageId] = now;
+  m_inFlightUpgrades[task.villageId][task.slotId] = now;
+  m_handoffs.remove(task.villageId);
+
+  fetcher->upgradeBuilding(task.villageId, task.slotId);
+  emit taskStarted(task.villageId, task.slotId, task.buildingName);
+}
+
+bool BuildQueueManager::isUpgradeInFlight(int villageId, int slotId) const {
+  auto village = m_inFlightUpgrades.constFind(villageId);
+  if (village == m_inFlightUpgrades.constEnd()) {
+    return false;
+  }
+  auto sent = village->constFind(slotId);
+  return sent != village->constEnd() &&
+         QDateTime::currentMSecsSinceEpoch() - sent.value() <
+             IN_FLIGHT_TIMEOUT_MS;
+}
+
+void BuildQueueManager::onUpgradeResponse(int villageId, int slotId) {
+  auto village = m_inFlightUpgrades.find(villageId);
+  if (village == m_inFlightUpgrades.end()) {
+    return;
+  }
+  village->remove(slotId);
+  if (village->isEmpty()) {
+    m_inFlightUpgrades.erase(village);
   }
 }
@@ -1,11 +1,13 @@
 #ifndef BUILDQUEUEMANAGER_H
 #define BUILDQUEUEMANAGER_H
 
+#include "src/managers/BuildOrderOptimizer.h"
 #include <QJsonObject>
 #include <QList>
 #include <QMap>
 #include <QObject>
 #include <QString>
+#include <QTimer>
 #include <QVariantMap>
 
 class TravianDataFetcher;
@@ -21,6 +23,7 @@ public:
     int targetLevel;
     QString buildingName;
     int priority;
+    bool autoPlanned = false; // FieldPlanner tarafından eklendi
 
     QJsonObject toJson() const;
     static BuildTask fromJson(const QJsonObject &obj);
@@ -32,6 +35,9 @@ public:
   void saveQueue(const QString &filePath);
   void addTask(const BuildTask &task);
   void removeTask(int villageId, int index);
+  // Köyün otomatik (FieldPlanner) görevlerini verilen listeyle değiştirir;
+  // elle eklenen görevlere dokunmaz
+  void replaceAutoTasks(int villageId, const QList<BuildTask> &tasks);
 
   // Per-village queue access
   QList<BuildTask> getQueue(int villageId) const;
@@ -43,25 +49,124 @@ public:
 
   int getCurrentLevel(const QVariantMap &villageData, int slotId) const;
 
+  // Plus hesabı: inşaat kuyruğuna bir bekleyen emir daha verilebilir
+  void setPlusAccount(bool plus) { m_plusAccount = plus; }
+  // İnşaat süreleri için sunucu hızı (ör. 3x için 3)
+  void setServerSpeed(double speed) { m_serverSpeed = speed; }
+
+  // Tüm köylerin planlanan inşaat zaman çizelgesi (UI için): villageId,
+  // slotId, buildingName, level, startAt, endAt (ms, -1 = öngörülemiyor)
+  QVariantList timeline() const;
+
   void processQueue(TravianDataFetcher *fetcher, const QVariantMap &allData);
+  void processVillage(TravianDataFetcher *fetcher, int villageId,
+                      const QVariantMap &villageData);
+
+  // Seconds until the next pending task of the village becomes affordable
+  // (0 = affordable now, -1 = no pending task / cannot be estimated)
+  int secondsUntilNextTaskAffordable(int villageId,
+                                     const QVariantMap &villageData) const;
 
-  // Returns remaining construction time in seconds, or 0 if builder is free
+  // Returns seconds until the next builder slot frees up (earliest
+  // construction end), or 0 if nothing is under construction
   int getBuilderRemainingTime(const QVariantMap &villageData) const;
 
+public slots:
+  // Fetcher'ın upgradeStarted/upgradeFailed bildirimi: yükseltme artık
+  // yanıt beklemiyor
+  void onUpgradeResponse(int villageId, int slotId);
+
 signals:
   void queueChanged();
   void taskStarted(int villageId, int slotId, const QString &buildingName);
   void taskCompleted(int villageId, int slotId);
   void builderBusy(int villageId, int remainingSeconds);
   void insufficientResources(int villageId, const QString &buildingName);
+  void timelineChanged();
+
+private slots:
+  void onTimer();
 
 private:
+  // İnşaat bitiminde sıradaki yükseltmeyi yenilemeyi beklemeden başlatır
+  struct Handoff {
+    int slotId = 0;
+    qint64 dueMs = 0; // inşaat bitişi + pay (yerel saat)
+    bool prefetched = false;
+  };
+
+  struct ConstructionEntry {
+    QString name;
+    bool field = false;  // kaynak alanı (Romalılarda ayrı inşaatçı)
+    int secondsLeft = 0; // sayfa yaşı düşülmüş
+    qint64 endsAtMs = 0; // mutlak bitiş (yerel saat)
+  };
+
+  struct IdleStats {
+    qint64 totalIdleSeconds = 0;
+    int starts = 0;
+  };
+
   QMap<int, QList<BuildTask>> m_queues; // villageId -> tasks
   QString m_queueFilePath;
 
-  bool isBuilderFree(const QVariantMap &villageData) const;
+  QList<ConstructionEntry>
+  constructionEntries(const QVariantMap &villageData) const;
+  // Halk (Romalı) ve Plus'a göre bu tipte bir inşaat daha başlatılabilir mi
+  bool hasFreeBuilderSlot(const QVariantMap &villageData, bool field) const;
+  bool isRoman(const QVariantMap &villageData) const;
+  static bool isResourceField(int slotId) {
+    return slotId >= 1 && slotId <= 18;
+  }
+  // Aynı döngüde başlatılan görevin kaynağını ve slotunu çalışma kopyasında
+  // ayırır
+  void reserveConstruction(QVariantMap &villageData, const BuildTask &task,
+                           int currentLevel) const;
+  // İlk bekleyen görevin slotu inşaat kuyruğunda olabilir mi (aynı adlı
+  // yapı). Olabilirse eski seviyeyle ikinci kez yükseltilmemesi için el
+  // değiştirme kurulmaz, yenileme beklenir
+  bool mayBeUnderConstruction(const QVariantMap &villageData,
+                              int slotId) const;
+  void scheduleHandoff(int villageId, const QVariantMap &villageData);
+  void armPreciseHandoff();
+  void runHandoff(int villageId, int slotId);
+  void startUpgrade(TravianDataFetcher *fetcher, const BuildTask &task);
+  // Yanıtı beklenen yükseltme; bu arada gelen veride henüz görünmez
+  bool isUpgradeInFlight(int villageId, int slotId) const;
+  // Bekleyen görevleri BuildOrderOptimizer ile sıralar (m_plans)
+  void planVillage(int villageId, const QVariantMap &villageData);
+  // Planlanan sıraya göre görevler (plan yoksa öncelik sırası)
+  QList<BuildTask> orderedTasks(int villageId) const;
+  int getGid(const QVariantMap &villageData, int slotId) const;
+  // Köyün stoğu; fetcher varsa VillageStore sütunlarından
+  ResourceSnapshot resources(const QVariantMap &villageData) const;
+  // Bir sonraki seviyenin tam maliyetine (BuildingData) göre; süre üretimden
+  // tahmin edilir (-1 = depo/tahıl yetmiyor ya da üretim yok)
   bool canAffordBuilding(const QVariantMap &villageData, int slotId,
                          int currentLevel) const;
+  int secondsUntilAffordable(const QVariantMap &villageData, int slotId,
+                             int currentLevel) const;
+
+  QMap<int, Handoff> m_handoffs;       // villageId -> el değiştirme
+  QMap<int, qint64> m_builderFreeAtMs; // son görülen inşaat bitişi
+  QMap<int, qint64> m_upgradeSentAtMs; // son yükseltme isteği
+  // villageId -> slotId -> gönderim anı (yanıt gelene kadar)
+  QMap<int, QMap<int, qint64>> m_inFlightUpgrades;
+  QMap<int, IdleStats> m_idleStats;    // inşaatçı boşta kalma süresi
+  QMap<int, QVariantMap> m_lastVillageData;
+  TravianDataFetcher *m_fetcher = nullptr;
+  QTimer *m_tickTimer = nullptr;
+  bool m_plusAccount = false;
+  double m_serverSpeed = 1.0;
+  QMap<int, QList<BuildOrderOptimizer::PlannedStep>> m_plans; // villageId
+
+  // Sunucu inşaatı bitirip yeni isteği kabul etsin diye bitişten sonra pay.
+  // Bitiş sunucu saatine hizalı olduğundan saniyeler değil, ms yeterli
+  static constexpr qint64 HANDOFF_MARGIN_MS = 1500;
+  // Bina sayfası bitişten bu kadar önce çekilir (link önbelleğe alınır)
+  static constexpr int PREFETCH_LEAD_SECONDS = 20;
+  // Yanıt hiç bildirilmezse (ağ hatası) yükseltme bu süreden sonra unutulur
+  static constexpr qint64 IN_FLIGHT_TIMEOUT_MS = 2 * 60 * 1000;
 };
 
 #endif // BUILDQUEUEMANAGER_H
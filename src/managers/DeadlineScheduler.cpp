@@ -0,0 +1,151 @@
+#include "src/managers/DeadlineScheduler.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QMap>
+#include <algorithm>
+
+DeadlineScheduler::DeadlineScheduler(QObject *parent) : QObject(parent) {
+  m_timer = new QTimer(this);
+  m_timer->setSingleShot(true);
+  m_timer->setTimerType(Qt::PreciseTimer);
+  connect(m_timer, &QTimer::timeout, this, &DeadlineScheduler::onTimer);
+}
+
+QString DeadlineScheduler::eventName(EventType type) {
+  switch (type) {
+  case ConstructionEnd:
+    return "construction";
+  case TroopQueueEnd:
+    return "troopQueue";
+  case FarmReturn:
+    return "farmReturn";
+  case ResourcesAffordable:
+    return "resources";
+  case StorageOverflow:
+    return "overflow";
+  default:
+    return "unknown";
+  }
+}
+
+void DeadlineScheduler::schedule(int villageId, EventType type, qint64 dueMs,
+                                 int pageMask) {
+  Event event;
+  event.dueMs = dueMs;
+  event.villageId = villageId;
+  event.type = type;
+  event.pageMask = pageMask;
+  event.seq = m_nextSeq++;
+
+  // Eski olay heap'te kalır ama seq eşleşmediği için yok sayılır
+  m_live[makeKey(villageId, type)] = event.seq;
+  m_heap.push_back(event);
+  std::push_heap(m_heap.begin(), m_heap.end(), Later());
+
+  // Sık yeniden planlamada biriken geçersiz kayıtları ara sıra temizle
+  if (m_heap.size() > static_cast<size_t>(m_live.size()) * 4 + 64) {
+    m_heap.erase(std::remove_if(m_heap.begin(), m_heap.end(),
+                                [this](const Event &e) { return !isLive(e); }),
+                 m_heap.end());
+    std::make_heap(m_heap.begin(), m_heap.end(), Later());
+  }
+
+  qDebug() << "[DEADLINE] Village" << villageId << eventName(type) << "in"
+           << (dueMs - QDateTime::currentMSecsSinceEpoch()) / 1000 << "s";
+
+  rearm();
+}
+
+void DeadlineScheduler::cancel(int villageId, EventType type) {
+  if (m_live.remove(makeKey(villageId, type)) > 0) {
+    rearm();
+  }
+}
+
+void DeadlineScheduler::cancelVillage(int villageId) {
+  for (int t = 0; t < EventTypeCount; ++t) {
+    m_live.remove(makeKey(villageId, static_cast<EventType>(t)));
+  }
+  rearm();
+}
+
+void DeadlineScheduler::clear() {
+  m_heap.clear();
+  m_live.clear();
+  m_timer->stop();
+}
+
+bool DeadlineScheduler::isLive(const Event &event) const {
+  return m_live.value(makeKey(event.villageId, event.type)) == event.seq;
+}
+
+void DeadlineScheduler::dropStale() {
+  while (!m_heap.empty() && !isLive(m_heap.front())) {
+    std::pop_heap(m_heap.begin(), m_heap.end(), Later());
+    m_heap.pop_back();
+  }
+}
+
+qint64 DeadlineScheduler::nextDeadlineMs() const {
+  // İptal edilmiş olaylar üstte olabilir - canlı olan en erkeni bul
+  if (m_heap.empty())
+    return 0;
+  if (isLive(m_heap.front()))
+    return m_heap.front().dueMs;
+
+  qint64 earliest = 0;
+  for (const Event &event : m_heap) {
+    if (isLive(event) && (earliest == 0 || event.dueMs < earliest))
+      earliest = event.dueMs;
+  }
+  return earliest;
+}
+
+int DeadlineScheduler::secondsUntilNext() const {
+  qint64 next = nextDeadlineMs();
+  if (next == 0)
+    return -1;
+  return static_cast<int>(
+      qMax<qint64>(0, next - QDateTime::currentMSecsSinceEpoch()) / 1000);
+}
+
+void DeadlineScheduler::rearm() {
+  dropStale();
+  if (m_heap.empty()) {
+    m_timer->stop();
+    return;
+  }
+
+  qint64 delay = m_heap.front().dueMs - QDateTime::currentMSecsSinceEpoch();
+  // QTimer int ms alır; çok uzak deadline'lar için ara uyanış yeterli
+  delay = qBound<qint64>(0, delay, 24LL * 3600 * 1000);
+  m_timer->start(static_cast<int>(delay));
+}
+
+void DeadlineScheduler::onTimer() {
+  qint64 horizon = QDateTime::currentMSecsSinceEpoch() + COALESCE_WINDOW_MS;
+
+  // villageId -> birleşik sayfa maskesi
+  QMap<int, int> dueVillages;
+
+  dropStale();
+  while (!m_heap.empty() && m_heap.front().dueMs <= horizon) {
+    Event event = m_heap.front();
+    std::pop_heap(m_heap.begin(), m_heap.end(), Later());
+    m_heap.pop_back();
+
+    if (isLive(event)) {
+      m_live.remove(makeKey(event.villageId, event.type));
+      dueVillages[event.villageId] |= event.pageMask;
+      qDebug() << "[DEADLINE] Fired:" << eventName(event.type) << "village"
+               << event.villageId;
+    }
+    dropStale();
+  }
+
+  rearm();
+
+  for (auto it = dueVillages.constBegin(); it != dueVillages.constEnd(); ++it) {
+    emit villageDue(it.key(), it.value());
+  }
+}
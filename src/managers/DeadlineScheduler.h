@@ -0,0 +1,81 @@
+#ifndef DEADLINESCHEDULER_H
+#define DEADLINESCHEDULER_H
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <vector>
+
+/**
+ * @brief Min-heap of per-village deadlines driving targeted refreshes
+ *
+ * Every village can have at most one pending event of each type (a newer
+ * schedule() replaces the older one). A single timer is armed for the
+ * earliest deadline; when it fires, all events due within a short window are
+ * merged per village and reported with the union of their page masks.
+ */
+class DeadlineScheduler : public QObject {
+  Q_OBJECT
+
+public:
+  enum EventType {
+    ConstructionEnd = 0,
+    TroopQueueEnd,
+    FarmReturn,
+    ResourcesAffordable,
+    StorageOverflow,
+    EventTypeCount
+  };
+
+  explicit DeadlineScheduler(QObject *parent = nullptr);
+
+  void schedule(int villageId, EventType type, qint64 dueMs, int pageMask);
+  void cancel(int villageId, EventType type);
+  void cancelVillage(int villageId);
+  void clear();
+
+  bool hasPending() const { return !m_live.isEmpty(); }
+  qint64 nextDeadlineMs() const;
+  int secondsUntilNext() const;
+
+  static QString eventName(EventType type);
+
+signals:
+  void villageDue(int villageId, int pageMask);
+
+private slots:
+  void onTimer();
+
+private:
+  struct Event {
+    qint64 dueMs;
+    int villageId;
+    EventType type;
+    int pageMask;
+    quint64 seq;
+  };
+
+  struct Later {
+    bool operator()(const Event &a, const Event &b) const {
+      return a.dueMs > b.dueMs;
+    }
+  };
+
+  static quint64 makeKey(int villageId, EventType type) {
+    return (static_cast<quint64>(villageId) << 8) | static_cast<quint64>(type);
+  }
+
+  bool isLive(const Event &event) const;
+  void dropStale();
+  void rearm();
+
+  std::vector<Event> m_heap;     // std::push_heap / pop_heap, en erken üstte
+  QHash<quint64, quint64> m_live; // (village, type) -> geçerli olayın seq'i
+  quint64 m_nextSeq = 1;
+  QTimer *m_timer = nullptr;
+
+  // Birbirine yakın olaylar tek istekte birleştirilir
+  static constexpr qint64 COALESCE_WINDOW_MS = 3000;
+};
+
+#endif // DEADLINESCHEDULER_H
@@ -120,6 +120,7 @@ void FarmListManager::removeListConfig(int listId) {
   stopListTimer(listId);
   m_configs.remove(listId);
   m_remainingSeconds.remove(listId);
+  m_roundTrips.remove(listId);
 
   saveConfig();
   emit configChanged();
@@ -187,8 +188,10 @@ void FarmListManager::startTimers() {
     m_tickTimer->start();
   }
 
+  // Her yenilemede çağrılır: çalışan sayaçlara dokunma, yoksa dönüş süresine
+  // göre kurulan son tarih hiç dolmaz. Sayaç gönderimden sonra yeniden kurulur
   for (auto it = m_configs.begin(); it != m_configs.end(); ++it) {
-    if (it.value().enabled) {
+    if (it.value().enabled && !m_remainingSeconds.contains(it.key())) {
       startListTimer(it.key());
     }
   }
@@ -206,18 +209,29 @@ void FarmListManager::startListTimer(int listId) {
     return;
 
   const FarmConfig &config = m_configs[listId];
-  int baseSeconds = config.intervalMinutes * 60;
-
-  // +/- %20 random jitter (ör. 5dk = 240-360sn arası)
-  int jitterRange = baseSeconds / 5;
-  int jitter = QRandomGenerator::global()->bounded(-jitterRange, jitterRange + 1);
+  int roundTrip = m_roundTrips.value(listId, 0);
+  int baseSeconds;
+  int jitter;
+
+  if (roundTrip > 0) {
+    // Birlikler dönmeden göndermek boşa gider - yalnızca ileri kaydır
+    // (0..+%10)
+    baseSeconds = qMax(MIN_ROUND_TRIP_SECONDS, roundTrip);
+    jitter = QRandomGenerator::global()->bounded(0, baseSeconds / 10 + 1);
+  } else {
+    // Dönüş süresi bilinmiyor: sabit aralık
+    // +/- %20 random jitter (ör. 5dk = 240-360sn arası)
+    baseSeconds = config.intervalMinutes * 60;
+    int jitterRange = baseSeconds / 5;
+    jitter = QRandomGenerator::global()->bounded(-jitterRange, jitterRange + 1);
+  }
   int finalSeconds = qMax(30, baseSeconds + jitter);
 
   m_remainingSeconds[listId] = finalSeconds;
 
   qDebug() << "[FARM_MGR] Timer set for list" << listId
-           << "base:" << baseSeconds << "s, jitter:" << jitter
-           << "s, total:" << finalSeconds << "s";
+           << (roundTrip > 0 ? "round trip:" : "base:") << baseSeconds
+           << "s, jitter:" << jitter << "s, total:" << finalSeconds << "s";
 
   // Ensure tick timer is running
   if (!m_tickTimer->isActive()) {
@@ -225,6 +239,27 @@ void FarmListManager::startListTimer(int listId) {
   }
 }
 
+void FarmListManager::setListRoundTrip(int listId, int seconds) {
+  if (seconds <= 0) {
+    m_roundTrips.remove(listId);
+    return;
+  }
+
+  int previous = m_roundTrips.value(listId, 0);
+  m_roundTrips[listId] = seconds;
+
+  // İlk kez öğrenildiyse sabit aralıkla kurulan sayacı kısalt; birlikler
+  // zaten daha önce dönüyor olabilir
+  if (previous == 0 && m_remainingSeconds.contains(listId) &&
+      m_remainingSeconds[listId] > seconds) {
+    m_remainingSeconds[listId] = qMax(MIN_ROUND_TRIP_SECONDS, seconds);
+    emit timerTick(listId, m_remainingSeconds[listId]);
+  }
+
+  qDebug() << "[FARM_MGR] Round trip for list" << listId << ":" << seconds
+           << "s";
+}
+
 void FarmListManager::stopListTimer(int listId) {
   m_remainingSeconds.remove(listId);
 }
@@ -244,14 +279,46 @@ void FarmListManager::onTimer() {
     }
   }
 
-  // Execute farm lists for expired timers
+  if (expiredLists.isEmpty() || !m_fetcher) {
+    return;
+  }
+
+  // Dispatch: süresi dolan listeleri köye göre grupla, aynı köyün kısa süre
+  // içinde zamanı gelecek listelerini de öne çekip tek istekte gönder
+  QMap<int, QList<int>> dueByVillage;
   for (int listId : expiredLists) {
-    if (m_fetcher && m_configs.contains(listId) &&
-        m_configs[listId].enabled) {
-      executeListNow(listId, m_fetcher, m_lastAllData);
+    if (m_configs.contains(listId) && m_configs[listId].enabled) {
+      dueByVillage[m_configs[listId].villageId].append(listId);
+    }
+  }
+
+  for (auto it = m_remainingSeconds.constBegin();
+       it != m_remainingSeconds.constEnd(); ++it) {
+    int listId = it.key();
+    if (it.value() <= 0 || it.value() > DISPATCH_WINDOW_SECONDS ||
+        !m_configs.contains(listId) || !m_configs[listId].enabled) {
+      continue;
+    }
+    int villageId = m_configs[listId].villageId;
+    if (dueByVillage.contains(villageId)) {
+      qDebug() << "[FARM_MGR] Pulling list" << listId << "forward by"
+               << it.value() << "s to batch with village" << villageId;
+      dueByVillage[villageId].append(listId);
+    }
+  }
+
+  for (auto it = dueByVillage.constBegin(); it != dueByVillage.constEnd();
+       ++it) {
+    const QList<int> &listIds = it.value();
+    qDebug() << "[FARM_MGR] Dispatching" << listIds.size()
+             << "farm list(s) from village" << it.key() << ":" << listIds;
+
+    for (int listId : listIds) {
+      emit farmExecutionStarted(it.key(), listId);
       // Reset timer
       startListTimer(listId);
     }
+    m_fetcher->executeFarmLists(it.key(), listIds);
   }
 }
 
@@ -15,7 +15,8 @@ class TravianDataFetcher;
  * @brief Per-farm-list configuration and independent timer manager
  *
  * Each farm list has its own independent timer and config.
- * When the timer fires, that specific list is executed via TravianDataFetcher.
+ * When a timer fires, the list is dispatched together with the other lists of
+ * the same village that are due within a short window, in a single request.
  */
 class FarmListManager : public QObject {
   Q_OBJECT
@@ -63,6 +64,10 @@ public:
   // Timer remaining seconds for a specific list
   int remainingSeconds(int listId) const;
 
+  // Slot mesafeleri ve birlik hızından hesaplanan gidiş-dönüş süresi; bilinen
+  // listeler intervalMinutes yerine bu süreyle yeniden kurulur
+  void setListRoundTrip(int listId, int seconds);
+
 signals:
   void configChanged();
   void farmExecutionStarted(int villageId, int listId);
@@ -77,9 +82,16 @@ private:
 
   QMap<int, FarmConfig> m_configs;       // listId -> config
   QMap<int, int> m_remainingSeconds;     // listId -> countdown
+  QMap<int, int> m_roundTrips;           // listId -> round trip seconds
   QTimer *m_tickTimer = nullptr;         // 1-second tick for countdowns
   QString m_configPath;
 
   TravianDataFetcher *m_fetcher = nullptr;
   QVariantMap m_lastAllData;
+
+  // Bu kadar saniye içinde zamanı gelecek listeler aynı köyün gönderimine
+  // eklenir
+  static constexpr int DISPATCH_WINDOW_SECONDS = 60;
+  // Çok yakın hedeflerde listeyi art arda ateşlememek için alt sınır
+  static constexpr int MIN_ROUND_TRIP_SECONDS = 60;
 };
@@ -0,0 +1,163 @@
+#include "src/managers/FieldPlanner.h"
+#include "src/models/BuildingData.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+void FieldPlanner::load(const QString &path) {
+  m_path = path;
+  m_villageCaps.clear();
+
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qDebug() << "[FIELD_PLAN] No config file found:" << path;
+    return;
+  }
+
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  file.close();
+
+  m_enabled = root["enabled"].toBool(false);
+  m_defaultCap = root["defaultCap"].toInt(10);
+  QJsonObject villages = root["villages"].toObject();
+  for (auto it = villages.constBegin(); it != villages.constEnd(); ++it) {
+    m_villageCaps.insert(it.key().toInt(), it.value().toInt());
+  }
+
+  qDebug() << "[FIELD_PLAN] Loaded config, enabled:" << m_enabled
+           << "default cap:" << m_defaultCap;
+}
+
+void FieldPlanner::save() const {
+  if (m_path.isEmpty())
+    return;
+
+  QJsonObject villages;
+  for (auto it = m_villageCaps.constBegin(); it != m_villageCaps.constEnd();
+       ++it) {
+    villages[QString::number(it.key())] = it.value();
+  }
+
+  QJsonObject root;
+  root["enabled"] = m_enabled;
+  root["defaultCap"] = m_defaultCap;
+  root["villages"] = villages;
+
+  QFile file(m_path);
+  if (file.open(QIODevice::WriteOnly)) {
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    file.close();
+  }
+}
+
+void FieldPlanner::setEnabled(bool enabled) {
+  m_enabled = enabled;
+  save();
+}
+
+void FieldPlanner::setDefaultCap(int cap) {
+  m_defaultCap = qBound(0, cap, BuildingData::MAX_LEVEL);
+  save();
+}
+
+void FieldPlanner::setVillageCap(int villageId, int cap) {
+  if (cap < 0) {
+    m_villageCaps.remove(villageId);
+  } else {
+    m_villageCaps[villageId] = qMin(cap, BuildingData::MAX_LEVEL);
+  }
+  save();
+}
+
+double FieldPlanner::paybackHours(int gid, int targetLevel) const {
+  const int *cost = BuildingData::cost(gid, targetLevel);
+  if (!cost || gid < 1 || gid > 4) {
+    return -1;
+  }
+
+  // Tahıl tüketimi de bir kaynak kaybı: net kazançtan düşülür
+  double added = (BuildingData::fieldProduction(targetLevel) -
+                  BuildingData::fieldProduction(targetLevel - 1)) *
+                     m_serverSpeed -
+                 BuildingData::upkeep(gid, targetLevel);
+  if (added <= 0) {
+    return -1;
+  }
+
+  int total = cost[0] + cost[1] + cost[2] + cost[3];
+  return total / added;
+}
+
+QList<FieldPlanner::Candidate> FieldPlanner::rank(const QVariantMap &allData,
+                                                  int limit) const {
+  QList<Candidate> candidates;
+
+  for (auto it = allData.constBegin(); it != allData.constEnd(); ++it) {
+    if (!it.key().startsWith("village_")) {
+      continue;
+    }
+    QVariantMap villageData = it.value().toMap();
+    int villageId = villageData["villageId"].toInt();
+    if (villageId <= 0) {
+      villageId = it.key().mid(8).toInt();
+    }
+    int cap = levelCap(villageId);
+
+    const QVariantList resourceFields =
+        villageData["dorf1"].toMap()["resourceFields"].toList();
+    for (const QVariant &field : resourceFields) {
+      QVariantMap fieldMap = field.toMap();
+      int level = fieldMap["level"].toInt();
+      if (level >= cap) {
+        continue;
+      }
+
+      Candidate candidate;
+      candidate.villageId = villageId;
+      candidate.slotId = fieldMap["slotId"].toInt();
+      candidate.gid = fieldMap["gid"].toInt();
+      candidate.level = level + 1;
+      candidate.paybackHours = paybackHours(candidate.gid, candidate.level);
+      if (candidate.paybackHours >= 0) {
+        candidates.append(candidate);
+      }
+    }
+  }
+
+  // Eşitlikte köy/slot sırası: plan her çalıştırmada aynı kalsın
+  auto better = [](const Candidate &a, const Candidate &b) {
+    if (a.paybackHours != b.paybackHours)
+      return a.paybackHours < b.paybackHours;
+    if (a.villageId != b.villageId)
+      return a.villageId < b.villageId;
+    return a.slotId < b.slotId;
+  };
+
+  if (limit >= 0 && limit < candidates.size()) {
+    std::partial_sort(candidates.begin(), candidates.begin() + limit,
+                      candidates.end(), better);
+    candidates.resize(limit);
+  } else {
+    std::sort(candidates.begin(), candidates.end(), better);
+  }
+  return candidates;
+}
+
+QMap<int, QList<FieldPlanner::Candidate>>
+FieldPlanner::selectTasks(const QVariantMap &allData) const {
+  QMap<int, QList<Candidate>> selected;
+  if (!m_enabled) {
+    return selected;
+  }
+
+  const QList<Candidate> ranked = rank(allData);
+  for (const Candidate &candidate : ranked) {
+    QList<Candidate> &tasks = selected[candidate.villageId];
+    if (tasks.size() < TASKS_PER_VILLAGE) {
+      tasks.append(candidate);
+    }
+  }
+  return selected;
+}
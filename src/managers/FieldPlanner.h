@@ -0,0 +1,68 @@
+#ifndef FIELDPLANNER_H
+#define FIELDPLANNER_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @brief Account-wide resource field planner ranked by payback time
+ *
+ * Every field below its village's level cap is a candidate for one more
+ * level. Payback = total cost / added hourly production, where the added
+ * production is net of the new level's crop upkeep. Candidates of all
+ * villages are ranked together. Each village gets its best
+ * TASKS_PER_VILLAGE candidates as automatic build tasks.
+ *
+ * Only table lookups and a partial sort, so recomputing for hundreds of
+ * villages on every snapshot is cheap.
+ *
+ * Config (field_planner.json):
+ *   {"enabled": true, "defaultCap": 10, "villages": {"<id>": 12}}
+ */
+class FieldPlanner {
+public:
+  struct Candidate {
+    int villageId = 0;
+    int slotId = 0;
+    int gid = 0;
+    int level = 0; // ulaşılacak seviye
+    double paybackHours = 0;
+  };
+
+  void load(const QString &path);
+  void save() const;
+
+  bool isEnabled() const { return m_enabled; }
+  void setEnabled(bool enabled);
+  int defaultCap() const { return m_defaultCap; }
+  void setDefaultCap(int cap);
+  void setVillageCap(int villageId, int cap); // cap < 0: varsayılana dön
+  int levelCap(int villageId) const {
+    return m_villageCaps.value(villageId, m_defaultCap);
+  }
+  // Sadece köye özel sınırlar (villageId -> cap)
+  QMap<int, int> villageCaps() const { return m_villageCaps; }
+  void setServerSpeed(double speed) { m_serverSpeed = speed; }
+
+  // Tüm köylerdeki adaylar, geri ödeme süresine göre sıralı (ilk limit tanesi)
+  QList<Candidate> rank(const QVariantMap &allData, int limit = -1) const;
+
+  // Köy başına otomatik görev olarak verilecek en iyi adaylar
+  QMap<int, QList<Candidate>> selectTasks(const QVariantMap &allData) const;
+
+  // Bir sonraki seviyenin geri ödeme süresi (saat); hesaplanamazsa -1
+  double paybackHours(int gid, int targetLevel) const;
+
+  static constexpr int TASKS_PER_VILLAGE = 1;
+
+private:
+  QString m_path;
+  bool m_enabled = false;
+  int m_defaultCap = 10;
+  QMap<int, int> m_villageCaps;
+  double m_serverSpeed = 1.0;
+};
+
+#endif // FIELDPLANNER_H
@@ -0,0 +1,91 @@
+#include "src/managers/OverflowMonitor.h"
+#include <QDebug>
+
+void OverflowMonitor::update(int villageId, const ResourceSnapshot &previous,
+                             const ResourceSnapshot &current) {
+  if (!previous.isValid() || !current.isValid() ||
+      current.fetchedAtMs() <= previous.fetchedAtMs()) {
+    return;
+  }
+
+  qint64 elapsedSeconds =
+      (current.fetchedAtMs() - previous.fetchedAtMs()) / 1000;
+
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    auto res = static_cast<ResourceSnapshot::Resource>(r);
+    if (current.stock(res) < current.capacity(res) * FULL_RATIO) {
+      continue;
+    }
+
+    // Önceki görüntüye göre ne zaman dolmuştu; o andan beri üretim boşa
+    int fullAfter = previous.secondsUntilFull(res, previous.fetchedAtMs());
+    if (fullAfter < 0 || fullAfter >= elapsedSeconds) {
+      continue;
+    }
+    qint64 wasted =
+        previous.production(res) * (elapsedSeconds - fullAfter) / 3600;
+    if (wasted > 0) {
+      m_waste[villageId].wasted[r] += wasted;
+      qDebug() << "[OVERFLOW] Village" << villageId << "resource" << r
+               << "was full for" << elapsedSeconds - fullAfter
+               << "s, wasted" << wasted;
+    }
+  }
+}
+
+int OverflowMonitor::secondsUntilOverflow(const ResourceSnapshot &snapshot,
+                                          qint64 nowMs, int *resource) const {
+  if (!snapshot.isValid()) {
+    return -1;
+  }
+
+  int earliest = -1;
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    int seconds = snapshot.secondsUntilFull(
+        static_cast<ResourceSnapshot::Resource>(r), nowMs);
+    if (seconds >= 0 && (earliest < 0 || seconds < earliest)) {
+      earliest = seconds;
+      if (resource) {
+        *resource = r;
+      }
+    }
+  }
+  return earliest;
+}
+
+qint64 OverflowMonitor::wastedForVillage(int villageId) const {
+  const VillageWaste waste = m_waste.value(villageId);
+  qint64 total = 0;
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    total += waste.wasted[r];
+  }
+  return total;
+}
+
+qint64 OverflowMonitor::wastedTotal() const {
+  qint64 total = 0;
+  for (auto it = m_waste.constBegin(); it != m_waste.constEnd(); ++it) {
+    total += wastedForVillage(it.key());
+  }
+  return total;
+}
+
+QVariantMap OverflowMonitor::kpi() const {
+  qint64 perResource[ResourceSnapshot::ResourceCount] = {};
+  QVariantMap villages;
+  for (auto it = m_waste.constBegin(); it != m_waste.constEnd(); ++it) {
+    for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+      perResource[r] += it.value().wasted[r];
+    }
+    villages[QString::number(it.key())] = wastedForVillage(it.key());
+  }
+
+  QVariantMap result;
+  result["total"] = wastedTotal();
+  result["lumber"] = perResource[ResourceSnapshot::Lumber];
+  result["clay"] = perResource[ResourceSnapshot::Clay];
+  result["iron"] = perResource[ResourceSnapshot::Iron];
+  result["crop"] = perResource[ResourceSnapshot::Crop];
+  result["villages"] = villages;
+  return result;
+}
@@ -0,0 +1,54 @@
+#ifndef OVERFLOWMONITOR_H
+#define OVERFLOWMONITOR_H
+
+#include "src/models/ResourceSnapshot.h"
+#include <QMap>
+#include <QVariantMap>
+
+/**
+ * @brief Warehouse/granary overflow forecast and wasted production KPI
+ *
+ * Projects a village's dorf1 snapshot forward to find when each resource
+ * reaches its cap. When a new snapshot shows a resource at the cap, the
+ * production lost since the previous snapshot is estimated as hourly
+ * production times the time spent full. That estimate feeds the wasted
+ * production KPI.
+ *
+ * Keeps no snapshots of its own: both come from ResourceProjector, which
+ * owns the per-village resource state.
+ */
+class OverflowMonitor {
+public:
+  // Projektör görüntüsü ilerlediğinde çağrılır; previous -> current arası
+  // boşa giden üretimi hesaplar
+  void update(int villageId, const ResourceSnapshot &previous,
+              const ResourceSnapshot &current);
+
+  /**
+   * @brief Seconds until the first resource of the village overflows
+   * @param resource İlk dolacak kaynak (ResourceSnapshot::Resource)
+   * @return 0 if already full, -1 if nothing will overflow
+   */
+  int secondsUntilOverflow(const ResourceSnapshot &snapshot, qint64 nowMs,
+                           int *resource = nullptr) const;
+
+  qint64 wastedTotal() const;
+  qint64 wastedForVillage(int villageId) const;
+  // UI için: {"total", "lumber", "clay", "iron", "crop", "villages": {id: n}}
+  QVariantMap kpi() const;
+
+  // Taşmadan bu kadar önce harcama/yenileme tetiklenir
+  static constexpr int OVERFLOW_LEAD_SECONDS = 10 * 60;
+
+private:
+  struct VillageWaste {
+    qint64 wasted[ResourceSnapshot::ResourceCount] = {};
+  };
+
+  QMap<int, VillageWaste> m_waste;
+
+  // Kapasitenin bu oranına ulaşan stok "dolu" sayılır (sayfa yuvarlaması)
+  static constexpr double FULL_RATIO = 0.99;
+};
+
+#endif // OVERFLOWMONITOR_H
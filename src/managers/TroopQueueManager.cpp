@@ -1,5 +1,9 @@
 #include "src/managers/TroopQueueManager.h"
+#include "src/models/ResourceSnapshot.h"
+#include "src/models/UnitData.h"
+#include "src/network/RefreshPlanner.h"
 #include "src/network/TravianDataFetcher.h"
+#include <QDateTime>
 #include <QDebug>
 #include <QFile>
 #include <QJsonArray>
@@ -20,6 +24,8 @@ QJsonObject TroopQueueManager::TroopConfig::toJson() const {
   obj["building"] = building;
   obj["intervalMinutes"] = intervalMinutes;
   obj["enabled"] = enabled;
+  obj["minBatch"] = minBatch;
+  obj["targetHorizonMinutes"] = targetHorizonMinutes;
   return obj;
 }
 
@@ -33,6 +39,8 @@ TroopQueueManager::TroopConfig::fromJson(int villageId,
   config.building = obj["building"].toString();
   config.intervalMinutes = obj["intervalMinutes"].toInt(5);
   config.enabled = obj["enabled"].toBool(false);
+  config.minBatch = qMax(1, obj["minBatch"].toInt(1));
+  config.targetHorizonMinutes = qMax(0, obj["targetHorizonMinutes"].toInt(0));
   return config;
 }
 
@@ -46,6 +54,13 @@ void TroopQueueManager::setVillageTroop(int villageId, const QString &troopId,
   config.troopName = troopName;
   config.building = building;
   config.intervalMinutes = intervalMinutes;
+  // Elle ayarlanan parti büyüklüğü ve hedef süre UI'dan yapılan
+  // değişiklikte korunur
+  if (hasConfig(villageId, building)) {
+    config.minBatch = m_configs[villageId][building].minBatch;
+    config.targetHorizonMinutes =
+        m_configs[villageId][building].targetHorizonMinutes;
+  }
 
   // Insert or update the config for this specific building in this village
   m_configs[villageId][building] = config;
@@ -100,6 +115,16 @@ bool TroopQueueManager::hasConfig(int villageId,
          m_configs[villageId].contains(building);
 }
 
+bool TroopQueueManager::hasEnabledConfigs() const {
+  for (const auto &innerMap : m_configs) {
+    for (const TroopConfig &config : innerMap) {
+      if (config.enabled)
+        return true;
+    }
+  }
+  return false;
+}
+
 void TroopQueueManager::loadConfig(const QString &filePath) {
   m_configFilePath = filePath;
   QFile file(filePath);
@@ -185,6 +210,7 @@ QVariantList TroopQueueManager::allConfigs() const {
       item["building"] = config.building;
       item["intervalMinutes"] = config.intervalMinutes;
       item["enabled"] = config.enabled;
+      item["targetHorizonMinutes"] = config.targetHorizonMinutes;
       item["remainingSeconds"] = remainingSeconds(villageId, config.building);
       result.append(item);
     }
@@ -218,6 +244,101 @@ int TroopQueueManager::findMilitarySlot(const QVariantMap &villageData,
   return -1;
 }
 
+int TroopQueueManager::trainingQueueSecondsLeft(
+    const QVariantMap &villageData, const QString &building) const {
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  int left = 0;
+
+  // Kuyruk sadece bizim eğitimlerimizle uzar, iki kaynak da alt sınırdır:
+  // daha uzun olanı kullan
+  auto consider = [&](const QVariantMap &page, bool filterByBuilding) {
+    qint64 fetchedAt = page.value("fetchedAt").toLongLong();
+    if (fetchedAt <= 0)
+      return;
+    int elapsed = static_cast<int>((now - fetchedAt) / 1000);
+
+    const QVariantList queue = page["trainingQueue"].toList();
+    for (const QVariant &item : queue) {
+      QVariantMap entry = item.toMap();
+      if (filterByBuilding &&
+          UnitData::buildingForUnit(entry["unitId"].toInt()) != building)
+        continue;
+      left = qMax(left, entry["remainingSeconds"].toInt() - elapsed);
+    }
+  };
+
+  // Bina sayfası (kümülatif satırlar) ve hesap geneli birlik genel bakışı
+  consider(villageData[building].toMap(), false);
+  consider(villageData["troopOverview"].toMap(), true);
+
+  // Kendi eğitimlerimizden bilinen kuyruk sonu
+  int villageId = villageData["villageId"].toInt();
+  qint64 queueEnd = m_queueEndMs.value(makeTimerKey(villageId, building), 0);
+  if (queueEnd > now) {
+    left = qMax(left, static_cast<int>((queueEnd - now) / 1000));
+  }
+
+  return left;
+}
+
+int TroopQueueManager::secondsUntilBatchAffordable(
+    const QVariantMap &villageData, const TroopConfig &config) const {
+  QString digits = config.troopId;
+  const int *unitCost = UnitData::cost(digits.remove(QChar('u')).toInt());
+  ResourceSnapshot snapshot = resources(villageData);
+  if (!unitCost || !snapshot.isValid()) {
+    return -1;
+  }
+
+  int batchCost[ResourceSnapshot::ResourceCount];
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    batchCost[r] = unitCost[r] * config.minBatch;
+  }
+  return snapshot.secondsUntilAffordable(batchCost,
+                                         QDateTime::currentMSecsSinceEpoch());
+}
+
+void TroopQueueManager::setVillageTroopHorizon(int villageId,
+                                                const QString &building,
+                                                int targetHorizonMinutes) {
+  if (!hasConfig(villageId, building)) {
+    return;
+  }
+
+  m_configs[villageId][building].targetHorizonMinutes =
+      qMax(0, targetHorizonMinutes);
+
+  if (!m_configFilePath.isEmpty()) {
+    saveConfig(m_configFilePath);
+  }
+
+  emit configChanged();
+}
+
+void TroopQueueManager::onTrainingQueueUpdated(int villageId,
+                                               const QString &troopId,
+                                               int queueSeconds) {
+  QString building = UnitData::buildingForUnit(troopId);
+  if (building.isEmpty() || queueSeconds <= 0) {
+    return;
+  }
+
+  QString key = makeTimerKey(villageId, building);
+  m_queueEndMs[key] =
+      QDateTime::currentMSecsSinceEpoch() + qint64(queueSeconds) * 1000;
+
+  // Hedef süre modunda bir sonraki tur kuyruk bitmeden hemen önce
+  if (hasConfig(villageId, building) &&
+      m_configs[villageId][building].enabled &&
+      m_configs[villageId][building].targetHorizonMinutes > 0) {
+    startVillageTimer(villageId, building,
+                      qMax(0, queueSeconds - REFILL_LEAD_SECONDS));
+  }
+
+  qDebug() << "[TROOP_MGR] Training queue for village" << villageId
+           << building << "ends in" << queueSeconds << "s";
+}
+
 void TroopQueueManager::setVillageTroopEnabled(int villageId,
                                                 const QString &building,
                                                 bool enabled) {
@@ -267,7 +388,10 @@ void TroopQueueManager::startTimers() {
     for (auto bIt = innerMap.begin(); bIt != innerMap.end(); ++bIt) {
       qDebug() << "[TROOP_MGR] Checking village" << villageId << bIt.key()
                << "enabled:" << bIt.value().enabled;
-      if (bIt.value().enabled) {
+      // Her yenilemede çağrılır: kurulu sayaçlar (kuyruk bitişi, kaynak
+      // yeterliliği, taşma) korunur; sadece sayacı olmayanlar kurulur
+      if (bIt.value().enabled &&
+          !m_remainingSeconds.contains(makeTimerKey(villageId, bIt.key()))) {
         startVillageTimer(villageId, bIt.key());
       }
     }
@@ -280,22 +404,33 @@ void TroopQueueManager::stopTimers() {
 }
 
 void TroopQueueManager::startVillageTimer(int villageId,
-                                          const QString &building) {
+                                          const QString &building,
+                                          int seconds) {
   if (!m_configs.contains(villageId) ||
       !m_configs[villageId].contains(building)) {
     return;
   }
 
   const TroopConfig &config = m_configs[villageId][building];
-  int baseSeconds = config.intervalMinutes * 60;
-
-  // +/- %20 random jitter
-  int jitterRange = baseSeconds / 5;
-  int jitter = QRandomGenerator::global()->bounded(-jitterRange, jitterRange + 1);
+  int baseSeconds = seconds >= 0 ? seconds : config.intervalMinutes * 60;
+
+  // +/- %20 random jitter; belirli bir ana kurulan sayaç yalnızca biraz
+  // ileri kayar (kuyruk boşalmadan çalması gerekir)
+  int jitter;
+  if (seconds >= 0) {
+    int maxDelay = qMin(baseSeconds / 20, REFILL_LEAD_SECONDS / 2);
+    jitter = QRandomGenerator::global()->bounded(0, maxDelay + 1);
+  } else {
+    int jitterRange = baseSeconds / 5;
+    jitter = QRandomGenerator::global()->bounded(-jitterRange, jitterRange + 1);
+  }
   int finalSeconds = qMax(30, baseSeconds + jitter);
 
   QString key = makeTimerKey(villageId, building);
   m_remainingSeconds[key] = finalSeconds;
+  // Normal kurulumda trainSoon işareti düşer; yoksa ilgisiz bir sonraki
+  // çalışmada kuyruk doluluğu kontrolü atlanırdı
+  m_spendNowKeys.remove(key);
 
   qDebug() << "[TROOP_MGR] Timer set for village" << villageId << building
            << "base:" << baseSeconds << "s, jitter:" << jitter
@@ -311,6 +446,7 @@ void TroopQueueManager::stopVillageTimer(int villageId,
                                          const QString &building) {
   QString key = makeTimerKey(villageId, building);
   m_remainingSeconds.remove(key);
+  m_spendNowKeys.remove(key);
 }
 
 void TroopQueueManager::onTimer() {
@@ -345,17 +481,159 @@ void TroopQueueManager::onTimer() {
     if (m_configs.contains(villageId) &&
         m_configs[villageId].contains(building) &&
         m_configs[villageId][building].enabled) {
-      executeTrainingNow(villageId, building, m_fetcher, m_lastAllData);
-      // Reset timer
-      startVillageTimer(villageId, building);
+      QVariantMap villageData =
+          m_lastAllData.value(QString("village_%1").arg(villageId)).toMap();
+      QString key = makeTimerKey(villageId, building);
+
+      // Kuyruk bir sonraki kontrolden sonra da dolu kalacaksa sayfa GET +
+      // POST turunu hiç yapma
+      const TroopConfig &config = m_configs[villageId][building];
+      int queueLeft = trainingQueueSecondsLeft(villageData, building);
+      int intervalSeconds = config.intervalMinutes * 60;
+      int horizonSeconds = config.targetHorizonMinutes * 60;
+      int affordableIn = secondsUntilBatchAffordable(villageData, config);
+      bool spendNow = m_spendNowKeys.contains(key);
+
+      // Sadece verilecek kararın dayandığı sayfa eskiyse yenile: kuyruk
+      // doluyken stoğa, eğitmeyecekken bina sayfasına bakılmaz
+      bool queueBusy =
+          horizonSeconds > 0 ? queueLeft > REFILL_LEAD_SECONDS
+                             : queueLeft > intervalSeconds;
+      bool stockDecision = spendNow || !queueBusy;
+      // Taşma işareti kuyruğu ancak karşılanabilirlik kesinse (0) aşar;
+      // -1 (tahmin edilemiyor) normal yoldan sayfada doğrulanır
+      bool spendNowTrains = spendNow && affordableIn == 0;
+      bool willTrain = spendNowTrains || (!queueBusy && affordableIn <= 0);
+      int militaryPage = RefreshPlanner::pageFromName(building);
+      int pageMask = isQueueEndKnown(villageId, building)
+                         ? RefreshPlanner::NoPage
+                         : militaryPage;
+      if (stockDecision) {
+        pageMask |= RefreshPlanner::Dorf1;
+      }
+      if (willTrain) {
+        pageMask |= militaryPage;
+      }
+      if (waitForFreshData(villageId, building, pageMask)) {
+        continue;
+      }
+      m_spendNowKeys.remove(key);
+
+      if (spendNowTrains) {
+        // Depo taşmak üzere: kaynak boşa gitmesin, kuyruk dolu olsa da eğit
+        qDebug() << "[TROOP_MGR] Storage about to overflow in village"
+                 << villageId << "- training" << building << "now";
+        executeTrainingNow(villageId, building, m_fetcher, m_lastAllData);
+        startVillageTimer(villageId, building);
+      } else if (horizonSeconds > 0 && queueLeft > REFILL_LEAD_SECONDS) {
+        // Hedef süre modu: kuyruk bitmek üzere olana kadar dokunma
+        qDebug() << "[TROOP_MGR] Skipping village" << villageId << building
+                 << "- queue drains in" << queueLeft << "s";
+        startVillageTimer(villageId, building,
+                          queueLeft - REFILL_LEAD_SECONDS);
+      } else if (horizonSeconds <= 0 && queueLeft > intervalSeconds) {
+        qDebug() << "[TROOP_MGR] Skipping village" << villageId << building
+                 << "- training queue still busy for" << queueLeft << "s";
+        startVillageTimer(villageId, building);
+      } else if (affordableIn > 0) {
+        // Kaynak yetmiyor: sayfayı çekip maxCount=0 görmek yerine
+        // karşılanabileceği ana kadar bekle. Yağma gibi girdiler tahmini
+        // öne çekebilir, bu yüzden aralıktan uzun beklenmez (kontrol yereldir)
+        qDebug() << "[TROOP_MGR] Skipping village" << villageId << building
+                 << "-" << config.minBatch << "x" << config.troopId
+                 << "affordable in" << affordableIn << "s";
+        startVillageTimer(villageId, building,
+                          qMin(affordableIn, intervalSeconds));
+      } else {
+        // Hedef süre modunda kuyruk yalnızca hedefe kadar doldurulur;
+        // başarılı eğitimde sayaç onTrainingQueueUpdated ile yeniden kurulur
+        int trainSeconds =
+            horizonSeconds > 0 ? qMax(0, horizonSeconds - queueLeft) : 0;
+        executeTrainingNow(villageId, building, m_fetcher, m_lastAllData,
+                           trainSeconds);
+        // Reset timer
+        startVillageTimer(villageId, building);
+      }
     }
   }
 }
 
+ResourceSnapshot
+TroopQueueManager::resources(const QVariantMap &villageData) const {
+  if (!m_fetcher) {
+    return ResourceSnapshot::fromVillageData(villageData);
+  }
+  return m_fetcher->villageStore().resources(villageData["villageId"].toInt());
+}
+
+bool TroopQueueManager::isQueueEndKnown(int villageId,
+                                        const QString &building) const {
+  if (m_queueEndMs.value(makeTimerKey(villageId, building), 0) >
+      QDateTime::currentMSecsSinceEpoch()) {
+    return true;
+  }
+  if (!m_fetcher) {
+    return false;
+  }
+  const VillageStore &store = m_fetcher->villageStore();
+  return store.pageFetchedAtMs(villageId, building) > 0 ||
+         store.pageFetchedAtMs(villageId, "troopOverview") > 0;
+}
+
+bool TroopQueueManager::waitForFreshData(int villageId,
+                                         const QString &building,
+                                         int pageMask) {
+  QString key = makeTimerKey(villageId, building);
+  if (!m_fetcher) {
+    m_staleRefreshGenerations.remove(key);
+    return false;
+  }
+
+  // Stok kendi sınırıyla, bina sayfası planlayıcının sınırıyla
+  const VillageStore &store = m_fetcher->villageStore();
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  RefreshPlanner::Page militaryPage = RefreshPlanner::pageFromName(building);
+  int stale =
+      RefreshPlanner::stalePages(store, villageId,
+                                 pageMask & RefreshPlanner::Dorf1,
+                                 MAX_STOCK_AGE_MS, now) |
+      RefreshPlanner::stalePages(store, villageId, pageMask & militaryPage,
+                                 RefreshPlanner::maxAgeMs(militaryPage), now);
+  if (stale == RefreshPlanner::NoPage) {
+    m_staleRefreshGenerations.remove(key);
+    return false;
+  }
+
+  // Aynı nesil hâlâ duruyorsa istenen yenileme gelmedi; eski veriyle devam
+  quint64 generation =
+      RefreshPlanner::newestGeneration(store, villageId, stale);
+  auto pending = m_staleRefreshGenerations.constFind(key);
+  if (pending != m_staleRefreshGenerations.constEnd() &&
+      pending.value() == generation) {
+    qDebug() << "[TROOP_MGR] Refresh for village" << villageId << building
+             << "did not arrive, using stale data";
+    m_staleRefreshGenerations.remove(key);
+    return false;
+  }
+
+  qDebug() << "[TROOP_MGR] Data for village" << villageId << building
+           << "is stale - requesting pages" << stale;
+  m_staleRefreshGenerations[key] = generation;
+  emit refreshRequested(villageId, stale);
+  // Sadece erteleme: taşma yüzünden öne çekildiyse işaret korunur
+  bool spendNow = m_spendNowKeys.contains(key);
+  startVillageTimer(villageId, building, STALE_REFRESH_WAIT_SECONDS);
+  if (spendNow) {
+    m_spendNowKeys.insert(key);
+  }
+  return true;
+}
+
 void TroopQueueManager::executeTrainingNow(int villageId,
                                            const QString &building,
                                            TravianDataFetcher *fetcher,
-                                           const QVariantMap &allData) {
+                                           const QVariantMap &allData,
+                                           int trainSeconds) {
   qDebug() << "[TROOP_MGR] executeTrainingNow called for village" << villageId << building;
 
   m_fetcher = fetcher;
@@ -399,7 +677,8 @@ void TroopQueueManager::executeTrainingNow(int villageId,
            << building << "troop:" << config.troopName;
 
   // Trigger training via fetcher
-  fetcher->trainTroops(villageId, slotId, config.troopId, config.troopName);
+  fetcher->trainTroops(villageId, slotId, config.troopId, config.troopName,
+                       trainSeconds);
 }
 
 int TroopQueueManager::remainingSeconds(int villageId,
@@ -408,6 +687,26 @@ int TroopQueueManager::remainingSeconds(int villageId,
   return m_remainingSeconds.value(key, 0);
 }
 
+void TroopQueueManager::trainSoon(int villageId) {
+  if (!m_configs.contains(villageId)) {
+    return;
+  }
+
+  const auto &innerMap = m_configs[villageId];
+  for (auto it = innerMap.begin(); it != innerMap.end(); ++it) {
+    QString key = makeTimerKey(villageId, it.key());
+    if (!it.value().enabled || !m_remainingSeconds.contains(key)) {
+      continue;
+    }
+    m_spendNowKeys.insert(key);
+    if (m_remainingSeconds[key] > SPEND_SOON_SECONDS) {
+      qDebug() << "[TROOP_MGR] Overflow ahead, timer for village" << villageId
+               << it.key() << "pulled in to" << SPEND_SOON_SECONDS << "s";
+      m_remainingSeconds[key] = SPEND_SOON_SECONDS;
+    }
+  }
+}
+
 void TroopQueueManager::processTraining(TravianDataFetcher *fetcher,
                                         const QVariantMap &allData) {
   qDebug() << "[TROOP_MGR] processTraining called, active timers:" << m_remainingSeconds.size();
@@ -417,3 +716,8 @@ void TroopQueueManager::processTraining(TravianDataFetcher *fetcher,
   // Start timers if not already running
   startTimers();
 }
+
+void TroopQueueManager::updateVillageData(int villageId,
+                                          const QVariantMap &villageData) {
+  m_lastAllData[QString("village_%1").arg(villageId)] = villageData;
+}
@@ -1,6 +1,7 @@
 #ifndef TROOPQUEUEMANAGER_H
 #define TROOPQUEUEMANAGER_H
 
+#include "src/models/ResourceSnapshot.h"
 #include <QJsonObject>
 #include <QList>
 #include <QMap>
@@ -8,6 +9,7 @@
 #include <QString>
 #include <QTimer>
 #include <QRandomGenerator>
+#include <QSet>
 #include <QVariantMap>
 
 class TravianDataFetcher;
@@ -23,6 +25,10 @@ public:
     QString building; // "barracks", "stable", "workshop"
     int intervalMinutes = 5; // Training check interval
     bool enabled = false; // Auto-training enabled
+    int minBatch = 1; // Sayfa ancak bu kadar birlik karşılanabilince çekilir
+    // > 0: kuyruk bu kadar dakikalık eğitimle dolu tutulur ve sayaç kuyruk
+    // bitmeden hemen önce çalar (0 = her aralıkta en fazla adet)
+    int targetHorizonMinutes = 0;
 
     QJsonObject toJson() const;
     static TroopConfig fromJson(int villageId, const QJsonObject &obj);
@@ -36,21 +42,29 @@ public:
                        int intervalMinutes);
   void removeVillageTroop(int villageId, const QString &building);
   void setVillageTroopEnabled(int villageId, const QString &building, bool enabled);
+  void setVillageTroopHorizon(int villageId, const QString &building,
+                              int targetHorizonMinutes);
 
   // Returns list of configs for a village (can be empty)
   QList<TroopConfig> getVillageTroops(int villageId) const;
 
   QList<int> getConfiguredVillages() const;
   bool hasConfig(int villageId, const QString &building) const;
+  bool hasEnabledConfigs() const;
 
   void loadConfig(const QString &filePath);
   void saveConfig(const QString &filePath);
 
   void processTraining(TravianDataFetcher *fetcher, const QVariantMap &allData);
 
+  // Köy bazlı yenilemeden gelen veriyi zamanlayıcıları bozmadan güncelle
+  void updateVillageData(int villageId, const QVariantMap &villageData);
+
   // Execute training for specific village+building
+  // trainSeconds > 0: kuyruğa yalnızca bu kadar sürelik birlik eklenir
   void executeTrainingNow(int villageId, const QString &building,
-                         TravianDataFetcher *fetcher, const QVariantMap &allData);
+                         TravianDataFetcher *fetcher, const QVariantMap &allData,
+                         int trainSeconds = 0);
 
   // Timer management
   void startTimers();
@@ -59,14 +73,26 @@ public:
   // Get remaining seconds for a village+building timer
   int remainingSeconds(int villageId, const QString &building) const;
 
+  // Depo taşmak üzere: köyün etkin sayaçlarını öne çek ve kuyruk dolu olsa
+  // da kaynak yettiği kadar eğit
+  void trainSoon(int villageId);
+
   // For UI - Returns flattened list of all configs
   QVariantList allConfigs() const;
 
+public slots:
+  // Eğitim POST'undan sonra fetcher'ın bildirdiği kuyruk sonu
+  void onTrainingQueueUpdated(int villageId, const QString &troopId,
+                              int queueSeconds);
+
 signals:
   void configChanged();
   void trainingStarted(int villageId, const QString &troopName, int count);
   void trainingFailed(int villageId, const QString &reason);
   void timerTick(int villageId, const QString &building, int remainingSeconds);
+  // Karar verilecek veri çok eski: köyün bu sayfaları yenilensin
+  // (RefreshPlanner::Page maskesi)
+  void refreshRequested(int villageId, int pageMask);
 
 private slots:
   void onTimer();
@@ -74,7 +100,25 @@ private slots:
 private:
   int findMilitarySlot(const QVariantMap &villageData,
                        const QString &building) const;
-  void startVillageTimer(int villageId, const QString &building);
+  // Bilinen en son veriye göre binanın eğitim kuyruğunun kalan süresi (sn)
+  int trainingQueueSecondsLeft(const QVariantMap &villageData,
+                               const QString &building) const;
+  // Son kaynak verisi ve üretime göre minBatch birliğin karşılanmasına kalan
+  // süre (sn); 0 = şimdi, -1 = tahmin edilemiyor
+  int secondsUntilBatchAffordable(const QVariantMap &villageData,
+                                  const TroopConfig &config) const;
+  // Köyün stoğu; fetcher varsa VillageStore sütunlarından
+  ResourceSnapshot resources(const QVariantMap &villageData) const;
+  // Eğitim kuyruğunun sonu herhangi bir kaynaktan biliniyor mu
+  bool isQueueEndKnown(int villageId, const QString &building) const;
+  // pageMask'teki sayfalar izin verilen yaştan eskiyse yenileme ister ve
+  // sayacı kısa süreye kurar (true); yenileme gelmediyse eski veriyle devam
+  // edilir (false). Damgalar VillageStore'dan okunur
+  bool waitForFreshData(int villageId, const QString &building,
+                        int pageMask);
+  // seconds < 0: intervalMinutes +/- %20
+  void startVillageTimer(int villageId, const QString &building,
+                         int seconds = -1);
   void stopVillageTimer(int villageId, const QString &building);
   QString makeTimerKey(int villageId, const QString &building) const;
 
@@ -83,12 +127,29 @@ private:
 
   // Timer management: "villageId:building" -> remaining seconds
   QMap<QString, int> m_remainingSeconds;
+  // "villageId:building" -> eğitim kuyruğunun bilinen bitişi (ms)
+  QMap<QString, qint64> m_queueEndMs;
+  // trainSoon ile öne çekilen sayaçlar (kuyruk doluluğu kontrolü atlanır)
+  QSet<QString> m_spendNowKeys;
+  // Eski veri için yenileme istenen sayaçlar -> istek anındaki sayfa nesli
+  QMap<QString, quint64> m_staleRefreshGenerations;
   QTimer *m_tickTimer = nullptr;
 
   QString m_configFilePath;
 
   TravianDataFetcher *m_fetcher = nullptr;
   QVariantMap m_lastAllData;
+
+  // Hedef süre modunda sayaç kuyruk bitmeden bu kadar önce çalar (sayfa +
+  // POST turu ve sayaç sapması için pay)
+  static constexpr int REFILL_LEAD_SECONDS = 90;
+  // trainSoon sonrası sayaç bu kadar saniyeye çekilir
+  static constexpr int SPEND_SOON_SECONDS = 5;
+  // Bundan eski dorf1 stoğuyla karar verilmez, önce sayfa yenilenir. Bina
+  // sayfası için RefreshPlanner::maxAgeMs geçerli
+  static constexpr qint64 MAX_STOCK_AGE_MS = 15 * 60 * 1000;
+  // Yenileme istendikten sonra sayacın yeniden çalacağı süre
+  static constexpr int STALE_REFRESH_WAIT_SECONDS = 60;
 };
 
 #endif // TROOPQUEUEMANAGER_H
@@ -0,0 +1,147 @@
+#include "src/models/BuildingData.h"
+
+namespace {
+
+// clang-format off
+constexpr BuildingInfo BUILDINGS[] = {
+    // Kaynak alanları
+    {1, "Woodcutter", {40, 100, 50, 60}, 1.67, 2, 20, 1780.0 / 3, 1.6, 1000.0 / 3},
+    {2, "Clay Pit", {80, 40, 80, 50}, 1.67, 2, 20, 1660.0 / 3, 1.6, 1000.0 / 3},
+    {3, "Iron Mine", {100, 80, 30, 60}, 1.67, 3, 20, 2350.0 / 3, 1.6, 1000.0 / 3},
+    {4, "Cropland", {70, 90, 70, 20}, 1.67, 0, 20, 1450.0 / 3, 1.6, 1000.0 / 3},
+    // Üretim binaları
+    {5, "Sawmill", {520, 380, 290, 90}, 1.80, 4, 5, 5400},
+    {6, "Brickyard", {440, 480, 320, 50}, 1.80, 3, 5, 5240},
+    {7, "Iron Foundry", {200, 450, 510, 120}, 1.80, 6, 5, 6480},
+    {8, "Grain Mill", {500, 440, 380, 1240}, 1.80, 3, 5, 4240},
+    {9, "Bakery", {1200, 1480, 870, 1600}, 1.80, 4, 5, 6080},
+    // Altyapı
+    {10, "Warehouse", {130, 160, 90, 40}, 1.28, 1, 20, 3875},
+    {11, "Granary", {80, 100, 70, 20}, 1.28, 1, 20, 3475},
+    {13, "Smithy", {180, 250, 500, 160}, 1.28, 4, 20, 3875},
+    {14, "Tournament Square", {1750, 2250, 1530, 240}, 1.28, 1, 20, 5375},
+    {15, "Main Building", {70, 40, 60, 20}, 1.28, 2, 20, 3875},
+    {16, "Rally Point", {110, 160, 90, 70}, 1.28, 1, 20, 3875},
+    {17, "Marketplace", {80, 70, 120, 70}, 1.28, 4, 20, 3675},
+    {18, "Embassy", {180, 130, 150, 80}, 1.28, 3, 20, 3875},
+    // Askeri
+    {19, "Barracks", {210, 140, 260, 120}, 1.28, 4, 20, 3875},
+    {20, "Stable", {260, 140, 220, 100}, 1.28, 5, 20, 4075},
+    {21, "Workshop", {460, 510, 600, 320}, 1.28, 3, 20, 4875},
+    {22, "Academy", {220, 160, 90, 40}, 1.28, 4, 20, 3875},
+    {23, "Cranny", {40, 50, 30, 10}, 1.28, 0, 10, 2625},
+    {24, "Town Hall", {1250, 1110, 1260, 600}, 1.28, 4, 20, 14375},
+    {25, "Residence", {580, 460, 350, 180}, 1.28, 1, 20, 3875},
+    {26, "Palace", {550, 800, 750, 250}, 1.28, 1, 20, 6875},
+    {27, "Treasury", {2880, 2740, 2580, 990}, 1.26, 4, 20, 9875},
+    {28, "Trade Office", {1400, 1330, 1200, 400}, 1.28, 3, 20, 4875},
+    {29, "Great Barracks", {630, 420, 780, 360}, 1.28, 4, 20, 3875},
+    {30, "Great Stable", {780, 420, 660, 300}, 1.28, 5, 20, 4075},
+    {31, "City Wall", {70, 90, 170, 70}, 1.28, 0, 20, 3875},
+    {32, "Earth Wall", {120, 200, 0, 80}, 1.28, 0, 20, 3875},
+    {33, "Palisade", {160, 100, 80, 60}, 1.28, 0, 20, 3875},
+    {34, "Stonemason", {155, 130, 125, 70}, 1.28, 2, 20, 5950},
+    {35, "Brewery", {1460, 930, 1250, 1740}, 1.40, 6, 10, 11750},
+    {36, "Trapper", {80, 120, 70, 90}, 1.28, 4, 20, 2000},
+    {37, "Hero's Mansion", {700, 670, 700, 240}, 1.33, 2, 20, 2300},
+    {38, "Great Warehouse", {650, 800, 450, 200}, 1.28, 1, 20, 10875},
+    {39, "Great Granary", {400, 500, 350, 100}, 1.28, 1, 20, 8875},
+    {41, "Horse Drinking Trough", {780, 420, 660, 540}, 1.28, 5, 20, 5950},
+    {42, "Stone Wall", {110, 160, 70, 60}, 1.28, 0, 20, 3875},
+    {43, "Makeshift Wall", {50, 80, 40, 30}, 1.28, 0, 20, 3875},
+    {44, "Command Center", {1600, 1250, 1050, 200}, 1.22, 1, 20, 3875},
+    {45, "Waterworks", {910, 945, 910, 340}, 1.31, 1, 20, 3875},
+};
+// clang-format on
+
+constexpr int roundTo(double value, int step) {
+  return static_cast<int>(value / step + 0.5) * step;
+}
+
+// Seviye başına değerler derleme zamanında açılır
+struct LevelTables {
+  int cost[BuildingData::MAX_GID + 1][BuildingData::MAX_LEVEL + 1][4] = {};
+  int time[BuildingData::MAX_GID + 1][BuildingData::MAX_LEVEL + 1] = {};
+  int upkeep[BuildingData::MAX_GID + 1][BuildingData::MAX_LEVEL + 1] = {};
+};
+
+constexpr LevelTables buildLevelTables() {
+  LevelTables tables;
+  for (const BuildingInfo &b : BUILDINGS) {
+    double costFactor = 1.0;
+    double timeFactor = 1.0;
+    for (int level = 1; level <= b.maxLevel; ++level) {
+      for (int r = 0; r < 4; ++r) {
+        tables.cost[b.gid][level][r] = roundTo(b.baseCost[r] * costFactor, 5);
+      }
+      int seconds = roundTo(b.timeA * timeFactor - b.timeB, 10);
+      tables.time[b.gid][level] = seconds > 0 ? seconds : 10;
+      tables.upkeep[b.gid][level] =
+          level == 1 ? b.upkeep : roundTo((5.0 * b.upkeep + level - 1) / 10, 1);
+
+      costFactor *= b.k;
+      timeFactor *= b.timeK;
+    }
+  }
+  return tables;
+}
+
+constexpr LevelTables LEVEL_TABLES = buildLevelTables();
+
+// Derleme zamanı kontrolü: Ana bina seviye 1 = 70/40/60/20, 2000 sn
+static_assert(LEVEL_TABLES.cost[15][1][0] == 70, "main building cost");
+static_assert(LEVEL_TABLES.time[15][1] == 2000, "main building time");
+static_assert(LEVEL_TABLES.cost[1][2][0] == 65, "woodcutter level 2 cost");
+
+// Kaynak alanı saatlik üretimi, seviye 0-20 (1x)
+constexpr int FIELD_PRODUCTION[] = {2,   5,   9,   15,  22,   33,   50,
+                                    70,  100, 145, 200, 280,  375,  495,
+                                    635, 800, 1000, 1300, 1600, 2000, 2450};
+static_assert(sizeof(FIELD_PRODUCTION) / sizeof(int) ==
+                  BuildingData::MAX_LEVEL + 1,
+              "field production table");
+
+bool inTable(const BuildingInfo *b, int level) {
+  return b && level >= 1 && level <= b->maxLevel;
+}
+
+} // namespace
+
+const BuildingInfo *BuildingData::find(int gid) {
+  for (const BuildingInfo &b : BUILDINGS) {
+    if (b.gid == gid)
+      return &b;
+  }
+  return nullptr;
+}
+
+const int *BuildingData::cost(int gid, int level) {
+  return inTable(find(gid), level) ? LEVEL_TABLES.cost[gid][level] : nullptr;
+}
+
+int BuildingData::buildSeconds(int gid, int level, int mainBuildingLevel,
+                               double serverSpeed) {
+  if (!inTable(find(gid), level))
+    return -1;
+
+  // Ana binanın her seviyesi süreyi ~%3.6 kısaltır (AB 20'de yarıya iner)
+  double factor = 1.0;
+  for (int l = 1; l < mainBuildingLevel; ++l)
+    factor *= 0.964;
+
+  double speed = serverSpeed > 0 ? serverSpeed : 1.0;
+  return static_cast<int>(LEVEL_TABLES.time[gid][level] * factor / speed + 0.5);
+}
+
+int BuildingData::upkeep(int gid, int level) {
+  return inTable(find(gid), level) ? LEVEL_TABLES.upkeep[gid][level] : 0;
+}
+
+int BuildingData::maxLevel(int gid) {
+  const BuildingInfo *b = find(gid);
+  return b ? b->maxLevel : 0;
+}
+
+int BuildingData::fieldProduction(int level) {
+  return level >= 0 && level <= MAX_LEVEL ? FIELD_PRODUCTION[level] : 0;
+}
@@ -0,0 +1,66 @@
+#ifndef BUILDINGDATA_H
+#define BUILDINGDATA_H
+
+/**
+ * @brief Sabit bina bilgisi (gid'e göre)
+ *
+ * Seviye başına maliyet, süre ve tahıl tüketimi bu temel değerlerden
+ * derleme zamanında hesaplanan tablolara açılır (T4 formülleri):
+ *   maliyet(l)  = 5'e yuvarla(baseCost * k^(l-1))
+ *   süre(l)     = 10'a yuvarla(timeA * timeK^(l-1) - timeB)   (AB 1, 1x)
+ *   tüketim(l)  = l == 1 ? upkeep : yuvarla((5 * upkeep + l - 1) / 10)
+ */
+struct BuildingInfo {
+  int gid = 0;
+  const char *name = "";
+  int baseCost[4] = {}; // odun, kil, demir, tahıl (seviye 1)
+  double k = 1.28;      // maliyet çarpanı
+  int upkeep = 0;       // seviye 1 tahıl tüketimi
+  int maxLevel = 20;
+  double timeA = 3875;
+  double timeK = 1.16;
+  double timeB = 1875;
+};
+
+class BuildingData {
+public:
+  static constexpr int MAX_GID = 45;
+  static constexpr int MAX_LEVEL = 20;
+
+  /**
+   * @brief Bina bilgisini bul
+   * @return Bilinmeyen gid'ler için nullptr
+   */
+  static const BuildingInfo *find(int gid);
+
+  /**
+   * @brief Verilen seviyeye yükseltmenin maliyeti (odun, kil, demir, tahıl)
+   * @return Bilinmeyen gid ya da tablonun dışındaki seviyeler için nullptr
+   */
+  static const int *cost(int gid, int level);
+
+  /**
+   * @brief Verilen seviyeye yükseltme süresi (sn)
+   * @param mainBuildingLevel Ana bina seviyesi (süreyi kısaltır)
+   * @param serverSpeed Sunucu hızı (ör. 3x için 3)
+   * @return Bilinmiyorsa -1
+   */
+  static int buildSeconds(int gid, int level, int mainBuildingLevel = 1,
+                          double serverSpeed = 1.0);
+
+  /**
+   * @brief Verilen seviyenin ek tahıl tüketimi
+   * @return Bilinmiyorsa 0
+   */
+  static int upkeep(int gid, int level);
+
+  static int maxLevel(int gid);
+
+  /**
+   * @brief Kaynak alanının saatlik üretimi (1x, bonus hariç)
+   * @return Seviye 0-20 dışında 0
+   */
+  static int fieldProduction(int level);
+};
+
+#endif // BUILDINGDATA_H
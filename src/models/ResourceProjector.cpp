@@ -0,0 +1,89 @@
+#include "src/models/ResourceProjector.h"
+#include <QDebug>
+#include <QStringList>
+#include <climits>
+#include <cstdlib>
+
+namespace {
+
+const char *const RESOURCE_KEYS[] = {"lumber", "clay", "iron", "crop"};
+
+} // namespace
+
+void ResourceProjector::reconcile(int villageId,
+                                  const ResourceSnapshot &current) {
+  if (!current.isValid()) {
+    return;
+  }
+
+  auto previous = m_snapshots.constFind(villageId);
+  if (previous != m_snapshots.constEnd() &&
+      current.fetchedAtMs() <= previous->fetchedAtMs()) {
+    // Aynı fetchedAt: stok bir işlem yanıtının kaynak çubuğundan düzeltilmiş
+    // olabilir; tahmin değil ölçüm, sapma örneği sayılmaz
+    if (current.fetchedAtMs() == previous->fetchedAtMs()) {
+      m_snapshots[villageId] = current;
+    }
+    return;
+  }
+
+  bool spent = m_spentSinceFetch.remove(villageId);
+  if (previous != m_snapshots.constEnd() && !spent) {
+    QStringList parts;
+    for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+      auto res = static_cast<ResourceSnapshot::Resource>(r);
+      int drift =
+          current.stock(res) - previous->projected(res, current.fetchedAtMs());
+      Drift &stats = m_drift[r];
+      stats.samples++;
+      stats.sumAbs += std::abs(drift);
+      stats.sumSigned += drift;
+      stats.maxAbs = qMax(stats.maxAbs, std::abs(drift));
+      parts << QString("%1 %2%3")
+                   .arg(RESOURCE_KEYS[r])
+                   .arg(drift >= 0 ? "+" : "")
+                   .arg(drift);
+    }
+    qDebug() << "[PROJECTION] Village" << villageId << "drift after"
+             << (current.fetchedAtMs() - previous->fetchedAtMs()) / 1000
+             << "s:" << parts.join(", ");
+  }
+
+  m_snapshots[villageId] = current;
+}
+
+QVariantMap ResourceProjector::projected(int villageId, qint64 nowMs) const {
+  QVariantMap result;
+  auto it = m_snapshots.constFind(villageId);
+  if (it == m_snapshots.constEnd()) {
+    return result;
+  }
+
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    result[RESOURCE_KEYS[r]] =
+        it->projected(static_cast<ResourceSnapshot::Resource>(r), nowMs);
+  }
+  // capacity() bilinmeyen kapasiteyi INT_MAX döndürür; UI'da 0 gösterilir
+  int warehouse = it->capacity(ResourceSnapshot::Lumber);
+  int granary = it->capacity(ResourceSnapshot::Crop);
+  result["warehouseCapacity"] = warehouse == INT_MAX ? 0 : warehouse;
+  result["granaryCapacity"] = granary == INT_MAX ? 0 : granary;
+  result["ageSeconds"] = qMax<qint64>(0, nowMs - it->fetchedAtMs()) / 1000;
+  return result;
+}
+
+QVariantMap ResourceProjector::driftStats() const {
+  QVariantMap result;
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    const Drift &stats = m_drift[r];
+    QVariantMap one;
+    one["samples"] = stats.samples;
+    one["meanAbs"] = stats.samples > 0 ? double(stats.sumAbs) / stats.samples
+                                       : 0.0;
+    one["maxAbs"] = stats.maxAbs;
+    one["bias"] = stats.samples > 0 ? double(stats.sumSigned) / stats.samples
+                                    : 0.0;
+    result[RESOURCE_KEYS[r]] = one;
+  }
+  return result;
+}
@@ -0,0 +1,57 @@
+#ifndef RESOURCEPROJECTOR_H
+#define RESOURCEPROJECTOR_H
+
+#include "src/models/ResourceSnapshot.h"
+#include <QMap>
+#include <QSet>
+#include <QVariantMap>
+
+/**
+ * @brief Live per-village resource estimate between dorf1 fetches
+ *
+ * Keeps the latest ResourceSnapshot of every village so "current stock" can
+ * be answered at any moment without a request. Every real fetch is compared
+ * with what the previous snapshot predicted for that moment. The difference
+ * (drift) is collected per resource and logged.
+ *
+ * Fetch intervals that included our own spending (upgrade or training) are
+ * not sampled, since that gap is expected. Raid bounty and merchants still
+ * show up as positive drift.
+ */
+class ResourceProjector {
+public:
+  // Gerçek bir fetch geldiğinde çağrılır (VillageStore::resources); sapmayı
+  // ölçer, görüntüyü günceller
+  void reconcile(int villageId, const ResourceSnapshot &current);
+
+  // Bu köyde kaynak harcandı: bir sonraki fetch sapma örneği sayılmaz
+  void markSpent(int villageId) { m_spentSinceFetch.insert(villageId); }
+
+  bool hasSnapshot(int villageId) const {
+    return m_snapshots.contains(villageId);
+  }
+  ResourceSnapshot snapshot(int villageId) const {
+    return m_snapshots.value(villageId);
+  }
+
+  // UI için: {"lumber", "clay", "iron", "crop", "warehouseCapacity",
+  // "granaryCapacity", "ageSeconds"}; görüntü yoksa boş
+  QVariantMap projected(int villageId, qint64 nowMs) const;
+
+  // Kaynak başına {"samples", "meanAbs", "maxAbs", "bias"}
+  QVariantMap driftStats() const;
+
+private:
+  struct Drift {
+    int samples = 0;
+    qint64 sumAbs = 0;
+    qint64 sumSigned = 0;
+    int maxAbs = 0;
+  };
+
+  QMap<int, ResourceSnapshot> m_snapshots;
+  QSet<int> m_spentSinceFetch;
+  Drift m_drift[ResourceSnapshot::ResourceCount];
+};
+
+#endif // RESOURCEPROJECTOR_H
@@ -0,0 +1,113 @@
+#include "src/models/ResourceSnapshot.h"
+#include <climits>
+
+namespace {
+
+int numberValue(const QVariant &value) {
+  // Sayfadan string olarak gelir, binlik ayırıcı "." olabilir
+  return value.toString().remove('.').toInt();
+}
+
+} // namespace
+
+ResourceSnapshot
+ResourceSnapshot::fromVillageData(const QVariantMap &villageData) {
+  return fromPage(villageData["dorf1"].toMap());
+}
+
+ResourceSnapshot ResourceSnapshot::fromPage(const QVariantMap &dorf1) {
+  const char *stockKeys[] = {"lumber", "clay", "iron", "crop"};
+  const char *productionKeys[] = {"productionLumber", "productionClay",
+                                  "productionIron", "productionCrop"};
+
+  ResourceSnapshot snapshot;
+  for (int r = 0; r < ResourceCount; ++r) {
+    snapshot.m_stock[r] = numberValue(dorf1[stockKeys[r]]);
+    snapshot.m_production[r] = numberValue(dorf1[productionKeys[r]]);
+  }
+  snapshot.m_warehouseCapacity = numberValue(dorf1["warehouseCapacity"]);
+  snapshot.m_granaryCapacity = numberValue(dorf1["granaryCapacity"]);
+  snapshot.m_fetchedAtMs = dorf1["fetchedAt"].toLongLong();
+  return snapshot;
+}
+
+ResourceSnapshot ResourceSnapshot::fromValues(
+    const int stock[ResourceCount], const int production[ResourceCount],
+    int warehouseCapacity, int granaryCapacity, qint64 fetchedAtMs) {
+  ResourceSnapshot snapshot;
+  for (int r = 0; r < ResourceCount; ++r) {
+    snapshot.m_stock[r] = stock[r];
+    snapshot.m_production[r] = production[r];
+  }
+  snapshot.m_warehouseCapacity = warehouseCapacity;
+  snapshot.m_granaryCapacity = granaryCapacity;
+  snapshot.m_fetchedAtMs = fetchedAtMs;
+  return snapshot;
+}
+
+int ResourceSnapshot::capacity(Resource r) const {
+  int cap = r == Crop ? m_granaryCapacity : m_warehouseCapacity;
+  // Kapasite okunamadıysa sınırlama yapma
+  return cap > 0 ? cap : INT_MAX;
+}
+
+void ResourceSnapshot::setStock(const int stock[ResourceCount], qint64 atMs) {
+  for (int r = 0; r < ResourceCount; ++r) {
+    m_stock[r] = stock[r];
+  }
+  m_fetchedAtMs = atMs;
+}
+
+int ResourceSnapshot::projected(Resource r, qint64 nowMs) const {
+  double elapsedHours =
+      m_fetchedAtMs > 0 ? qMax<qint64>(0, nowMs - m_fetchedAtMs) / 3600000.0
+                        : 0.0;
+  double value = m_stock[r] + m_production[r] * elapsedHours;
+  return static_cast<int>(qBound(0.0, value, double(capacity(r))));
+}
+
+int ResourceSnapshot::secondsUntilAffordable(const int cost[ResourceCount],
+                                             qint64 nowMs) const {
+  int worst = 0;
+  for (int r = 0; r < ResourceCount; ++r) {
+    Resource res = static_cast<Resource>(r);
+    if (cost[r] > capacity(res)) {
+      return -1; // Depo yetmiyor
+    }
+
+    int missing = cost[r] - projected(res, nowMs);
+    if (missing <= 0) {
+      continue;
+    }
+    if (m_production[r] <= 0) {
+      return -1; // Üretim yok, tahmin edilemez
+    }
+    worst = qMax(worst,
+                 static_cast<int>(missing * 3600.0 / m_production[r]) + 1);
+  }
+  return worst;
+}
+
+int ResourceSnapshot::secondsUntilFull(Resource r, qint64 nowMs) const {
+  int cap = r == Crop ? m_granaryCapacity : m_warehouseCapacity;
+  if (cap <= 0 || m_production[r] <= 0) {
+    return -1;
+  }
+  int missing = cap - projected(r, nowMs);
+  if (missing <= 0) {
+    return 0;
+  }
+  return static_cast<int>(missing * 3600.0 / m_production[r]);
+}
+
+int ResourceSnapshot::affordableCount(const int cost[ResourceCount],
+                                      qint64 nowMs) const {
+  int count = INT_MAX;
+  for (int r = 0; r < ResourceCount; ++r) {
+    if (cost[r] <= 0) {
+      continue;
+    }
+    count = qMin(count, projected(static_cast<Resource>(r), nowMs) / cost[r]);
+  }
+  return count == INT_MAX ? 0 : count;
+}
@@ -0,0 +1,67 @@
+#ifndef RESOURCESNAPSHOT_H
+#define RESOURCESNAPSHOT_H
+
+#include <QVariantMap>
+
+/**
+ * @brief Last known resources of a village projected forward in time
+ *
+ * Built from the dorf1 page data (stock, hourly production, warehouse and
+ * granary capacity, "fetchedAt"). The projection assumes nothing was spent
+ * since the page was fetched, so it is an upper bound; callers still verify
+ * on the real page before acting.
+ */
+class ResourceSnapshot {
+public:
+  enum Resource { Lumber = 0, Clay, Iron, Crop, ResourceCount };
+
+  static ResourceSnapshot fromVillageData(const QVariantMap &villageData);
+  static ResourceSnapshot fromPage(const QVariantMap &dorf1);
+  // Önceden ayrıştırılmış değerlerden (VillageStore sütunları)
+  static ResourceSnapshot fromValues(const int stock[ResourceCount],
+                                     const int production[ResourceCount],
+                                     int warehouseCapacity, int granaryCapacity,
+                                     qint64 fetchedAtMs);
+
+  bool isValid() const { return m_fetchedAtMs > 0; }
+  qint64 fetchedAtMs() const { return m_fetchedAtMs; }
+
+  int stock(Resource r) const { return m_stock[r]; }
+  int production(Resource r) const { return m_production[r]; }
+  int capacity(Resource r) const;
+
+  // Stoğu başka bir sayfadan (ör. bina sayfasının kaynak çubuğu) gelen
+  // değerlerle değiştirir; üretim ve kapasite korunur
+  void setStock(const int stock[ResourceCount], qint64 atMs);
+
+  // Depo/ambar sınırıyla kırpılmış tahmini stok
+  int projected(Resource r, qint64 nowMs) const;
+
+  /**
+   * @brief Seconds until the stock covers the given cost
+   * @param cost odun, kil, demir, tahıl
+   * @return 0 if affordable now, -1 if it never will be (no production or
+   *         cost above storage capacity)
+   */
+  int secondsUntilAffordable(const int cost[ResourceCount],
+                             qint64 nowMs) const;
+
+  /**
+   * @brief Seconds until the resource reaches its storage cap
+   * @return 0 if already full, -1 if it never will be (no production or
+   *         unknown capacity)
+   */
+  int secondsUntilFull(Resource r, qint64 nowMs) const;
+
+  // Tahmini stokla karşılanabilecek adet
+  int affordableCount(const int cost[ResourceCount], qint64 nowMs) const;
+
+private:
+  int m_stock[ResourceCount] = {};
+  int m_production[ResourceCount] = {}; // saatlik, tahıl negatif olabilir
+  int m_warehouseCapacity = 0;
+  int m_granaryCapacity = 0;
+  qint64 m_fetchedAtMs = 0;
+};
+
+#endif // RESOURCESNAPSHOT_H
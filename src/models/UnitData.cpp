@@ -0,0 +1,112 @@
+#include "src/models/UnitData.h"
+
+namespace {
+
+// clang-format off
+constexpr UnitInfo UNITS[] = {
+    // Romalılar
+    {1, "Legionnaire", "barracks", 6, {120, 100, 150, 30}},
+    {2, "Praetorian", "barracks", 5, {100, 130, 160, 70}},
+    {3, "Imperian", "barracks", 7, {150, 160, 210, 80}},
+    {4, "Equites Legati", "stable", 16, {140, 160, 20, 40}},
+    {5, "Equites Imperatoris", "stable", 14, {550, 440, 320, 100}},
+    {6, "Equites Caesaris", "stable", 10, {550, 640, 800, 180}},
+    {7, "Battering Ram", "workshop", 4, {900, 360, 500, 70}},
+    {8, "Fire Catapult", "workshop", 3, {950, 1350, 600, 90}},
+    {9, "Senator", "residence", 4, {30750, 27200, 45000, 37500}},
+    {10, "Settler", "residence", 5, {4600, 4200, 5800, 4400}},
+    // Cermenler
+    {11, "Clubswinger", "barracks", 7, {95, 75, 40, 40}},
+    {12, "Spearman", "barracks", 7, {145, 70, 85, 40}},
+    {13, "Axeman", "barracks", 6, {130, 120, 170, 70}},
+    {14, "Scout", "barracks", 9, {160, 100, 50, 50}},
+    {15, "Paladin", "stable", 10, {370, 270, 290, 75}},
+    {16, "Teutonic Knight", "stable", 9, {450, 515, 480, 80}},
+    {17, "Ram", "workshop", 4, {1000, 300, 350, 70}},
+    {18, "Catapult", "workshop", 3, {900, 1200, 600, 60}},
+    {19, "Chief", "residence", 4, {35500, 26600, 25000, 27200}},
+    {20, "Settler", "residence", 5, {5800, 4400, 4600, 5200}},
+    // Galyalılar
+    {21, "Phalanx", "barracks", 7, {100, 130, 55, 30}},
+    {22, "Swordsman", "barracks", 6, {140, 150, 185, 60}},
+    {23, "Pathfinder", "stable", 17, {170, 150, 20, 40}},
+    {24, "Theutates Thunder", "stable", 19, {350, 450, 230, 60}},
+    {25, "Druidrider", "stable", 16, {360, 330, 280, 120}},
+    {26, "Haeduan", "stable", 13, {500, 620, 675, 170}},
+    {27, "Ram", "workshop", 4, {950, 555, 330, 75}},
+    {28, "Trebuchet", "workshop", 3, {960, 1450, 630, 90}},
+    {29, "Chieftain", "residence", 5, {30750, 45400, 31000, 37500}},
+    {30, "Settler", "residence", 5, {4400, 5600, 4200, 3900}},
+    // Mısırlılar
+    {51, "Slave Militia", "barracks", 7, {45, 60, 30, 15}},
+    {52, "Ash Warden", "barracks", 6, {115, 100, 145, 60}},
+    {53, "Khopesh Warrior", "barracks", 7, {170, 180, 220, 80}},
+    {54, "Sopdu Explorer", "stable", 16, {170, 150, 20, 40}},
+    {55, "Anhur Guard", "stable", 15, {360, 330, 280, 120}},
+    {56, "Resheph Chariot", "stable", 10, {450, 560, 610, 180}},
+    {57, "Ram", "workshop", 4, {995, 575, 340, 80}},
+    {58, "Stone Catapult", "workshop", 3, {980, 1510, 660, 100}},
+    {59, "Nomarch", "residence", 5, {34000, 50000, 34000, 42000}},
+    {60, "Settler", "residence", 5, {5040, 6510, 4830, 4620}},
+    // Hunlar
+    {61, "Mercenary", "barracks", 6, {130, 80, 40, 40}},
+    {62, "Bowman", "barracks", 6, {140, 110, 60, 60}},
+    {63, "Spotter", "stable", 19, {170, 150, 20, 40}},
+    {64, "Steppe Rider", "stable", 16, {290, 370, 190, 45}},
+    {65, "Marksman", "stable", 15, {320, 350, 330, 50}},
+    {66, "Marauder", "stable", 14, {450, 560, 610, 140}},
+    {67, "Ram", "workshop", 4, {1060, 330, 360, 70}},
+    {68, "Catapult", "workshop", 3, {950, 1280, 620, 60}},
+    {69, "Logades", "residence", 5, {37200, 27600, 25200, 27600}},
+    {70, "Settler", "residence", 5, {6100, 4600, 4800, 5400}},
+};
+// clang-format on
+
+} // namespace
+
+const UnitInfo *UnitData::find(int unitId) {
+  for (const UnitInfo &unit : UNITS) {
+    if (unit.id == unitId)
+      return &unit;
+  }
+  return nullptr;
+}
+
+QString UnitData::buildingForUnit(int unitId) {
+  const UnitInfo *unit = find(unitId);
+  return unit ? QString::fromLatin1(unit->building) : QString();
+}
+
+int UnitData::speed(int unitId) {
+  const UnitInfo *unit = find(unitId);
+  return unit ? unit->speed : 0;
+}
+
+const int *UnitData::cost(int unitId) {
+  const UnitInfo *unit = find(unitId);
+  return unit ? unit->cost : nullptr;
+}
+
+QString UnitData::buildingForUnit(const QString &unitClass) {
+  QString digits = unitClass;
+  digits.remove(QChar('u'));
+  return buildingForUnit(digits.toInt());
+}
+
+int UnitData::globalId(int tribe, int localId) {
+  // Kabile numarası -> ID ofseti (4=Doğa ve 5=Natarlar oynanamaz)
+  switch (tribe) {
+  case 1:
+    return localId;
+  case 2:
+    return 10 + localId;
+  case 3:
+    return 20 + localId;
+  case 6:
+    return 50 + localId;
+  case 7:
+    return 60 + localId;
+  default:
+    return 0;
+  }
+}
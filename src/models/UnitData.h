@@ -0,0 +1,54 @@
+#ifndef UNITDATA_H
+#define UNITDATA_H
+
+#include <QString>
+
+/**
+ * @brief Sabit birlik bilgisi (global birlik ID'sine göre)
+ *
+ * Global ID'ler oyunun "unit uXX" sınıflarıyla aynıdır: Romalılar 1-10,
+ * Cermenler 11-20, Galyalılar 21-30, Mısırlılar 51-60, Hunlar 61-70.
+ */
+struct UnitInfo {
+  int id = 0;
+  const char *name = "";
+  const char *building = ""; // "barracks", "stable", "workshop", "residence"
+  int speed = 0;             // alan/saat (1x sunucu)
+  int cost[4] = {};          // odun, kil, demir, tahıl
+};
+
+class UnitData {
+public:
+  /**
+   * @brief Birlik bilgisini bul
+   * @return Bilinmeyen birlikler için nullptr
+   */
+  static const UnitInfo *find(int unitId);
+
+  /**
+   * @brief Birliğin eğitildiği bina ("u21" ya da 21 kabul edilir)
+   * @return Bilinmeyen birlikler için boş string
+   */
+  static QString buildingForUnit(int unitId);
+  static QString buildingForUnit(const QString &unitClass);
+
+  /**
+   * @brief Birliğin 1x sunucudaki hızı (alan/saat)
+   * @return Bilinmeyen birlikler için 0
+   */
+  static int speed(int unitId);
+
+  /**
+   * @brief Tek birliğin eğitim maliyeti (odun, kil, demir, tahıl)
+   * @return Bilinmeyen birlikler için nullptr
+   */
+  static const int *cost(int unitId);
+
+  /**
+   * @brief Kabileye göre yerel ID'yi (t1..t10) global ID'ye çevir
+   * @param tribe dorf1 "tribe" değeri (1=Romalı, 2=Cermen, 3=Galya, ...)
+   */
+  static int globalId(int tribe, int localId);
+};
+
+#endif // UNITDATA_H
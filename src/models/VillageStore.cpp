@@ -0,0 +1,229 @@
+#include "src/models/VillageStore.h"
+#include <climits>
+
+namespace {
+
+const char *const STOCK_KEYS[] = {"lumber", "clay", "iron", "crop"};
+
+} // namespace
+
+void VillageStore::storePage(int villageId, const QString &villageName,
+                             const QString &pageName, const QVariantMap &data,
+                             qint64 fetchedAtMs, quint64 generation) {
+  int r = ensureRow(villageId, villageName);
+  PageColumn &column = m_columns[ensureColumn(pageName)];
+
+  QVariantMap &cell = column.data[r];
+  cell = data;
+  cell["fetchedAt"] = fetchedAtMs;
+  cell["generation"] = generation;
+  column.fetchedAtMs[r] = fetchedAtMs;
+  column.generation[r] = generation;
+
+  if (pageName == "dorf1") {
+    updateResources(r, cell);
+  }
+}
+
+void VillageStore::setStock(int villageId,
+                            const int stock[ResourceSnapshot::ResourceCount],
+                            quint64 generation) {
+  int r = row(villageId);
+  auto columnIt = m_columnIndex.constFind("dorf1");
+  if (r < 0 || columnIt == m_columnIndex.constEnd() ||
+      m_resourcesAtMs[r] <= 0) {
+    return;
+  }
+
+  PageColumn &column = m_columns[columnIt.value()];
+  QVariantMap &cell = column.data[r];
+  for (int i = 0; i < ResourceSnapshot::ResourceCount; ++i) {
+    m_stock[i][r] = stock[i];
+    cell[STOCK_KEYS[i]] = QString::number(stock[i]);
+  }
+  cell["generation"] = generation;
+  column.generation[r] = generation;
+}
+
+QString VillageStore::villageName(int villageId) const {
+  int r = row(villageId);
+  return r < 0 ? QString() : m_names[r];
+}
+
+QVariantMap VillageStore::page(int villageId, const QString &pageName) const {
+  int r = row(villageId);
+  auto columnIt = m_columnIndex.constFind(pageName);
+  if (r < 0 || columnIt == m_columnIndex.constEnd()) {
+    return QVariantMap();
+  }
+  return m_columns[columnIt.value()].data[r];
+}
+
+qint64 VillageStore::pageFetchedAtMs(int villageId,
+                                     const QString &pageName) const {
+  int r = row(villageId);
+  auto columnIt = m_columnIndex.constFind(pageName);
+  if (r < 0 || columnIt == m_columnIndex.constEnd()) {
+    return 0;
+  }
+  return m_columns[columnIt.value()].fetchedAtMs[r];
+}
+
+quint64 VillageStore::pageGeneration(int villageId,
+                                     const QString &pageName) const {
+  int r = row(villageId);
+  auto columnIt = m_columnIndex.constFind(pageName);
+  if (r < 0 || columnIt == m_columnIndex.constEnd()) {
+    return 0;
+  }
+  return m_columns[columnIt.value()].generation[r];
+}
+
+ResourceSnapshot VillageStore::resources(int villageId) const {
+  int r = row(villageId);
+  if (r < 0 || m_resourcesAtMs[r] <= 0) {
+    return ResourceSnapshot();
+  }
+
+  int stock[ResourceSnapshot::ResourceCount];
+  int production[ResourceSnapshot::ResourceCount];
+  for (int i = 0; i < ResourceSnapshot::ResourceCount; ++i) {
+    stock[i] = m_stock[i][r];
+    production[i] = m_production[i][r];
+  }
+  return ResourceSnapshot::fromValues(stock, production,
+                                      m_warehouseCapacity[r],
+                                      m_granaryCapacity[r], m_resourcesAtMs[r]);
+}
+
+QList<int> VillageStore::retain(const QSet<int> &keepIds) {
+  QList<int> removed;
+  // Sondan başa: removeRow son satırı boşalan yere taşır
+  for (int r = m_ids.size() - 1; r >= 0; --r) {
+    if (!keepIds.contains(m_ids[r])) {
+      removed.append(m_ids[r]);
+      removeRow(r);
+    }
+  }
+  return removed;
+}
+
+QVariantMap VillageStore::villageData(int villageId) const {
+  QVariantMap result;
+  int r = row(villageId);
+  if (r < 0) {
+    return result;
+  }
+
+  for (const PageColumn &column : m_columns) {
+    if (column.fetchedAtMs[r] > 0) {
+      result[column.name] = column.data[r];
+    }
+  }
+  result["villageName"] = m_names[r];
+  result["villageId"] = villageId;
+  return result;
+}
+
+void VillageStore::writeTo(QVariantMap &target) const {
+  for (int id : m_ids) {
+    target["village_" + QString::number(id)] = villageData(id);
+  }
+}
+
+int VillageStore::ensureRow(int villageId, const QString &villageName) {
+  int r = row(villageId);
+  if (r >= 0) {
+    if (!villageName.isEmpty()) {
+      m_names[r] = villageName;
+    }
+    return r;
+  }
+
+  r = m_ids.size();
+  m_rows.insert(villageId, r);
+  m_ids.append(villageId);
+  m_names.append(villageName);
+  for (PageColumn &column : m_columns) {
+    column.data.append(QVariantMap());
+    column.fetchedAtMs.append(0);
+    column.generation.append(0);
+  }
+  for (int i = 0; i < ResourceSnapshot::ResourceCount; ++i) {
+    m_stock[i].append(0);
+    m_production[i].append(0);
+  }
+  m_warehouseCapacity.append(0);
+  m_granaryCapacity.append(0);
+  m_resourcesAtMs.append(0);
+  return r;
+}
+
+int VillageStore::ensureColumn(const QString &pageName) {
+  auto it = m_columnIndex.constFind(pageName);
+  if (it != m_columnIndex.constEnd()) {
+    return it.value();
+  }
+
+  PageColumn column;
+  column.name = pageName;
+  column.data.resize(m_ids.size());
+  column.fetchedAtMs.fill(0, m_ids.size());
+  column.generation.fill(0, m_ids.size());
+  m_columns.append(column);
+  m_columnIndex.insert(pageName, m_columns.size() - 1);
+  return m_columns.size() - 1;
+}
+
+void VillageStore::updateResources(int row, const QVariantMap &dorf1) {
+  ResourceSnapshot snapshot = ResourceSnapshot::fromPage(dorf1);
+  for (int i = 0; i < ResourceSnapshot::ResourceCount; ++i) {
+    auto res = static_cast<ResourceSnapshot::Resource>(i);
+    m_stock[i][row] = snapshot.stock(res);
+    m_production[i][row] = snapshot.production(res);
+  }
+  // capacity() bilinmeyen kapasiteyi INT_MAX döndürür; sütunda 0 tutulur
+  int warehouse = snapshot.capacity(ResourceSnapshot::Lumber);
+  int granary = snapshot.capacity(ResourceSnapshot::Crop);
+  m_warehouseCapacity[row] = warehouse == INT_MAX ? 0 : warehouse;
+  m_granaryCapacity[row] = granary == INT_MAX ? 0 : granary;
+  m_resourcesAtMs[row] = snapshot.fetchedAtMs();
+}
+
+void VillageStore::removeRow(int row) {
+  // Son satırı boşalan yere taşı; satırlar sık kalır
+  int last = m_ids.size() - 1;
+  m_rows.remove(m_ids[row]);
+  if (row != last) {
+    m_rows[m_ids[last]] = row;
+    m_ids[row] = m_ids[last];
+    m_names[row] = m_names[last];
+    for (PageColumn &column : m_columns) {
+      column.data[row] = column.data[last];
+      column.fetchedAtMs[row] = column.fetchedAtMs[last];
+      column.generation[row] = column.generation[last];
+    }
+    for (int i = 0; i < ResourceSnapshot::ResourceCount; ++i) {
+      m_stock[i][row] = m_stock[i][last];
+      m_production[i][row] = m_production[i][last];
+    }
+    m_warehouseCapacity[row] = m_warehouseCapacity[last];
+    m_granaryCapacity[row] = m_granaryCapacity[last];
+    m_resourcesAtMs[row] = m_resourcesAtMs[last];
+  }
+
+  m_ids.removeLast();
+  m_names.removeLast();
+  for (PageColumn &column : m_columns) {
+    column.data.removeLast();
+    column.fetchedAtMs.removeLast();
+    column.generation.removeLast();
+  }
+  for (int i = 0; i < ResourceSnapshot::ResourceCount; ++i) {
+    m_stock[i].removeLast();
+    m_production[i].removeLast();
+  }
+  m_warehouseCapacity.removeLast();
+  m_granaryCapacity.removeLast();
+  m_resourcesAtMs.removeLast();
+}
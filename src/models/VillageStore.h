@@ -0,0 +1,81 @@
+#ifndef VILLAGESTORE_H
+#define VILLAGESTORE_H
+
+#include "src/models/ResourceSnapshot.h"
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @brief Page data of all villages, indexed by village id
+ *
+ * Each village gets a dense row the first time one of its pages is stored.
+ * Each page name (dorf1, dorf2, barracks, troopOverview, ...) is a column.
+ * Storing a page replaces a single cell in place, so the village's other
+ * pages are never copied.
+ *
+ * Numbers read on hot paths live in typed parallel arrays next to the cells
+ * (struct-of-arrays): every page's "fetchedAt" and "generation", plus dorf1
+ * stock, production and capacity. The managers read those through the typed
+ * accessors; views in the old "village_<id>" QVariantMap layout are built
+ * only on request, for QML.
+ */
+class VillageStore {
+public:
+  // Sayfayı yerinde yazar; veriye "fetchedAt" ve "generation" eklenir
+  void storePage(int villageId, const QString &villageName,
+                 const QString &pageName, const QVariantMap &data,
+                 qint64 fetchedAtMs, quint64 generation);
+  // dorf1 stoğunu değiştirir; zaman tabanı (fetchedAt) aynı kalır
+  void setStock(int villageId, const int stock[ResourceSnapshot::ResourceCount],
+                quint64 generation);
+
+  QString villageName(int villageId) const;
+
+  // Damgalı sayfa verisi; yoksa boş (kopyalamadan, paylaşımlı)
+  QVariantMap page(int villageId, const QString &pageName) const;
+  qint64 pageFetchedAtMs(int villageId, const QString &pageName) const;
+  quint64 pageGeneration(int villageId, const QString &pageName) const;
+  // dorf1 sütunlarından; dorf1 yoksa geçersiz
+  ResourceSnapshot resources(int villageId) const;
+
+  // keepIds dışındaki köyleri siler, silinen id'leri döndürür
+  QList<int> retain(const QSet<int> &keepIds);
+
+  // {"dorf1": {...}, ..., "villageName", "villageId"}; köy yoksa boş
+  QVariantMap villageData(int villageId) const;
+  // Her köy "village_<id>" anahtarıyla target'a yazılır
+  void writeTo(QVariantMap &target) const;
+
+private:
+  struct PageColumn {
+    QString name;
+    QList<QVariantMap> data;
+    QList<qint64> fetchedAtMs;
+    QList<quint64> generation;
+  };
+
+  int row(int villageId) const { return m_rows.value(villageId, -1); }
+  int ensureRow(int villageId, const QString &villageName);
+  int ensureColumn(const QString &pageName);
+  void updateResources(int row, const QVariantMap &dorf1);
+  void removeRow(int row);
+
+  QHash<int, int> m_rows; // villageId -> satır
+  QList<int> m_ids;       // satır -> villageId
+  QList<QString> m_names;
+
+  QHash<QString, int> m_columnIndex; // sayfa adı -> sütun
+  QList<PageColumn> m_columns;
+
+  // dorf1'den, satır başına
+  QList<int> m_stock[ResourceSnapshot::ResourceCount];
+  QList<int> m_production[ResourceSnapshot::ResourceCount];
+  QList<int> m_warehouseCapacity;
+  QList<int> m_granaryCapacity;
+  QList<qint64> m_resourcesAtMs; // 0: dorf1 yok
+};
+
+#endif // VILLAGESTORE_H
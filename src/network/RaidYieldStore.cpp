@@ -0,0 +1,167 @@
+#include "src/network/RaidYieldStore.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+void RaidYieldStore::load(const QString &path) {
+  m_path = path;
+  m_slots.clear();
+
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qDebug() << "[RAID_YIELD] No history file found:" << path;
+    return;
+  }
+
+  // {"slots": {"<slotId>": [listId, raids, loot, capacity, losses,
+  //                         badStreak, lastResult, lastRaidTime,
+  //                         sendsSkipped]}}
+  QJsonObject slots =
+      QJsonDocument::fromJson(file.readAll()).object()["slots"].toObject();
+  file.close();
+
+  for (auto it = slots.constBegin(); it != slots.constEnd(); ++it) {
+    QJsonArray v = it.value().toArray();
+    if (v.size() < 9)
+      continue;
+
+    SlotStats stats;
+    stats.listId = v[0].toInt();
+    stats.raids = v[1].toInt();
+    stats.lootTotal = v[2].toInteger();
+    stats.capacityTotal = v[3].toInteger();
+    stats.losses = v[4].toInt();
+    stats.badStreak = v[5].toInt();
+    stats.lastResult = v[6].toInt();
+    stats.lastRaidTime = v[7].toInteger();
+    stats.sendsSkipped = v[8].toInt();
+    m_slots.insert(it.key().toInt(), stats);
+  }
+
+  qDebug() << "[RAID_YIELD] Loaded history for" << m_slots.size() << "slots";
+}
+
+void RaidYieldStore::save() const {
+  if (m_path.isEmpty())
+    return;
+
+  QJsonObject slots;
+  for (auto it = m_slots.constBegin(); it != m_slots.constEnd(); ++it) {
+    const SlotStats &s = it.value();
+    slots[QString::number(it.key())] =
+        QJsonArray{s.listId,     s.raids,        s.lootTotal,
+                   s.capacityTotal, s.losses,     s.badStreak,
+                   s.lastResult, s.lastRaidTime, s.sendsSkipped};
+  }
+
+  QJsonObject root;
+  root["slots"] = slots;
+
+  QFile file(m_path);
+  if (file.open(QIODevice::WriteOnly)) {
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.close();
+  }
+}
+
+bool RaidYieldStore::recordRaid(int listId, int slotId, qint64 raidTime,
+                                RaidResult result, int loot, int capacity) {
+  if (raidTime <= 0 || raidTime == m_slots.value(slotId).lastRaidTime)
+    return false;
+
+  SlotStats &stats = m_slots[slotId];
+  stats.listId = listId;
+  bool lootKnown = loot >= 0;
+  if (lootKnown) {
+    stats.raids++;
+    stats.lootTotal += loot;
+    stats.capacityTotal += qMax(0, capacity);
+  }
+  if (result == WonWithLosses || result == Lost)
+    stats.losses++;
+
+  // Boş dönen ya da birlik kaybeden yağma verimsizdir. Ganimeti bilinmeyen
+  // kazanılmış yağma seriyi ne bozar ne uzatır
+  if (result == Lost || (lootKnown && loot == 0))
+    stats.badStreak++;
+  else if (lootKnown)
+    stats.badStreak = 0;
+  stats.lastResult = result;
+  stats.lastRaidTime = raidTime;
+
+  if (stats.badStreak == DEAD_STREAK) {
+    qDebug() << "[RAID_YIELD] Slot" << slotId << "marked dead after"
+             << DEAD_STREAK << "unproductive raids";
+  }
+  return true;
+}
+
+bool RaidYieldStore::isDead(int slotId) const {
+  return m_slots.value(slotId).badStreak >= DEAD_STREAK;
+}
+
+double RaidYieldStore::yieldRatio(int slotId) const {
+  const SlotStats stats = m_slots.value(slotId);
+  if (stats.raids < MIN_RAIDS_FOR_RATIO || stats.capacityTotal <= 0)
+    return -1.0;
+  return static_cast<double>(stats.lootTotal) / stats.capacityTotal;
+}
+
+bool RaidYieldStore::shouldSend(const SlotStats &stats) const {
+  if (stats.badStreak >= DEAD_STREAK)
+    return stats.sendsSkipped + 1 >= DEAD_PROBE_INTERVAL;
+
+  if (stats.raids >= MIN_RAIDS_FOR_RATIO && stats.capacityTotal > 0 &&
+      static_cast<double>(stats.lootTotal) / stats.capacityTotal <
+          LOW_YIELD_RATIO)
+    return stats.sendsSkipped >= 1;
+
+  return true;
+}
+
+QJsonArray RaidYieldStore::selectTargets(const QJsonArray &slotIds) {
+  QJsonArray selected;
+  int skipped = 0;
+
+  for (const QJsonValue &value : slotIds) {
+    int slotId = value.toInt();
+    auto it = m_slots.find(slotId);
+    if (it == m_slots.end()) {
+      // Geçmişi olmayan slot her zaman gider
+      selected.append(slotId);
+      continue;
+    }
+
+    if (shouldSend(it.value())) {
+      it.value().sendsSkipped = 0;
+      selected.append(slotId);
+    } else {
+      it.value().sendsSkipped++;
+      skipped++;
+    }
+  }
+
+  if (skipped > 0) {
+    qDebug() << "[RAID_YIELD] Skipped" << skipped << "of" << slotIds.size()
+             << "slots";
+    save();
+  }
+  return selected;
+}
+
+void RaidYieldStore::retainSlots(int listId, const QSet<int> &slotIds) {
+  int before = m_slots.size();
+  for (auto it = m_slots.begin(); it != m_slots.end();) {
+    if (it.value().listId != listId || slotIds.contains(it.key()))
+      ++it;
+    else
+      it = m_slots.erase(it);
+  }
+
+  if (m_slots.size() != before) {
+    qDebug() << "[RAID_YIELD] Dropped history of" << before - m_slots.size()
+             << "removed slots";
+    save();
+  }
+}
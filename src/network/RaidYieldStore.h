@@ -0,0 +1,75 @@
+#ifndef RAIDYIELDSTORE_H
+#define RAIDYIELDSTORE_H
+
+#include <QHash>
+#include <QJsonArray>
+#include <QSet>
+#include <QString>
+
+/**
+ * @brief Per-slot raid outcome history used to prune farm list targets
+ *
+ * Every farm list slot remembers how many raids returned, how much they
+ * carried home relative to their capacity and how the last raids ended. Slots
+ * that keep coming back empty or losing troops are left out of the send
+ * (with an occasional probe so they can recover), low-yield slots are sent
+ * every other time and productive slots are always sent.
+ *
+ * The history is kept as compact JSON next to farm_config.json.
+ */
+class RaidYieldStore {
+public:
+  enum RaidResult {
+    Unknown = 0,
+    Won = 1,         // kayıpsız
+    WonWithLosses = 2,
+    Lost = 3         // hiçbir birlik dönmedi
+  };
+
+  void load(const QString &path);
+  void save() const;
+
+  // Bir slotun son yağma raporu (farm list görünüm verisinden).
+  // Aynı rapor (raidTime) tekrar gelirse yok sayılır. loot < 0: ganimet
+  // bilinmiyor; verim hesabına girmez, boş yağma sayılmaz.
+  bool recordRaid(int listId, int slotId, qint64 raidTime, RaidResult result,
+                  int loot, int capacity);
+
+  // Gönderime girecek hedefleri seçer ve gönderim sayaçlarını ilerletir
+  QJsonArray selectTargets(const QJsonArray &slotIds);
+
+  // Listeden silinen slotların geçmişini bırakır
+  void retainSlots(int listId, const QSet<int> &slotIds);
+
+  bool isDead(int slotId) const;
+  double yieldRatio(int slotId) const;
+
+private:
+  struct SlotStats {
+    int listId = 0;
+    int raids = 0;          // ganimeti bilinen rapor
+    qint64 lootTotal = 0;   // taşınan toplam hammadde
+    qint64 capacityTotal = 0;
+    int losses = 0;         // kayıplı ya da kaybedilen yağma
+    int badStreak = 0;      // art arda boş ya da kaybedilen yağma
+    int lastResult = Unknown;
+    qint64 lastRaidTime = 0;
+    int sendsSkipped = 0;   // seçilmediği ardışık gönderim
+  };
+
+  bool shouldSend(const SlotStats &stats) const;
+
+  QHash<int, SlotStats> m_slots; // slotId -> stats
+  QString m_path;
+
+  // Bu kadar art arda boş/kayıp yağmadan sonra slot ölü sayılır
+  static constexpr int DEAD_STREAK = 3;
+  // Ölü slot her bu kadar gönderimde bir yoklanır
+  static constexpr int DEAD_PROBE_INTERVAL = 10;
+  // Ortalama doluluk bu oranın altındaysa slot iki gönderimde bir gider
+  static constexpr double LOW_YIELD_RATIO = 0.25;
+  // Oran hesaplamak için gereken en az rapor
+  static constexpr int MIN_RAIDS_FOR_RATIO = 3;
+};
+
+#endif // RAIDYIELDSTORE_H
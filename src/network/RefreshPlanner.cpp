@@ -0,0 +1,182 @@
+#include "src/network/RefreshPlanner.h"
+#include "src/models/VillageStore.h"
+#include <QDebug>
+#include <QStringList>
+#include <QVariantList>
+
+RefreshPlanner::Page RefreshPlanner::pageFromName(const QString &pageName) {
+  if (pageName == "dorf1")
+    return Dorf1;
+  if (pageName == "dorf2")
+    return Dorf2;
+  if (pageName == "barracks")
+    return Barracks;
+  if (pageName == "stable")
+    return Stable;
+  if (pageName == "workshop")
+    return Workshop;
+  return NoPage;
+}
+
+QString RefreshPlanner::pageName(Page page) {
+  switch (page) {
+  case Dorf1:
+    return "dorf1";
+  case Dorf2:
+    return "dorf2";
+  case Barracks:
+    return "barracks";
+  case Stable:
+    return "stable";
+  case Workshop:
+    return "workshop";
+  default:
+    return QString();
+  }
+}
+
+qint64 RefreshPlanner::maxAgeMs(Page page) {
+  switch (page) {
+  case Dorf1:
+    return DORF1_MAX_AGE_MS;
+  case Dorf2:
+    return DORF2_MAX_AGE_MS;
+  default:
+    return MILITARY_MAX_AGE_MS;
+  }
+}
+
+int RefreshPlanner::parseDuration(const QString &hhmmss) {
+  QStringList parts = hhmmss.split(":");
+  if (parts.size() != 3)
+    return -1;
+  return parts[0].toInt() * 3600 + parts[1].toInt() * 60 + parts[2].toInt();
+}
+
+bool RefreshPlanner::isFullSweepDue(qint64 nowMs) const {
+  return m_lastFullSweepMs == 0 ||
+         nowMs - m_lastFullSweepMs >= FULL_SWEEP_INTERVAL_MS;
+}
+
+void RefreshPlanner::beginCycle(qint64 nowMs) {
+  m_fullSweep = isFullSweepDue(nowMs);
+  if (m_fullSweep) {
+    m_lastFullSweepMs = nowMs;
+    qDebug() << "[PLANNER] Full sweep cycle - all pages will be fetched";
+  }
+}
+
+bool RefreshPlanner::isDue(int villageId, Page page, qint64 nowMs) const {
+  if (m_fullSweep)
+    return true;
+
+  auto villageIt = m_pages.constFind(villageId);
+  if (villageIt == m_pages.constEnd())
+    return true;
+
+  auto pageIt = villageIt->constFind(page);
+  if (pageIt == villageIt->constEnd() || pageIt->fetchedAtMs == 0)
+    return true;
+
+  if (pageIt->deadlineMs > 0 && pageIt->deadlineMs <= nowMs)
+    return true;
+
+  return nowMs - pageIt->fetchedAtMs >= maxAgeMs(page);
+}
+
+quint64 RefreshPlanner::newestGeneration(const VillageStore &store,
+                                         int villageId, int pageMask) {
+  quint64 newest = 0;
+  for (Page page : {Dorf1, Dorf2, Barracks, Stable, Workshop}) {
+    if (pageMask & page)
+      newest = qMax(newest, store.pageGeneration(villageId, pageName(page)));
+  }
+  return newest;
+}
+
+int RefreshPlanner::stalePages(const VillageStore &store, int villageId,
+                               int pageMask, qint64 maxAgeMs, qint64 nowMs) {
+  int mask = NoPage;
+  for (Page page : {Dorf1, Dorf2, Barracks, Stable, Workshop}) {
+    if (!(pageMask & page))
+      continue;
+    qint64 fetchedAt = store.pageFetchedAtMs(villageId, pageName(page));
+    if (fetchedAt <= 0 || nowMs - fetchedAt > maxAgeMs)
+      mask |= page;
+  }
+  return mask;
+}
+
+int RefreshPlanner::duePages(int villageId, qint64 nowMs) const {
+  int mask = NoPage;
+  for (Page page : {Dorf1, Dorf2, Barracks, Stable, Workshop}) {
+    if (isDue(villageId, page, nowMs))
+      mask |= page;
+  }
+  return mask;
+}
+
+void RefreshPlanner::markFetched(int villageId, const QString &pageName,
+                                 const QVariantMap &data, qint64 nowMs) {
+  Page page = pageFromName(pageName);
+  if (page == NoPage)
+    return;
+
+  PageState &state = m_pages[villageId][page];
+  state.fetchedAtMs = nowMs;
+  if (state.deadlineMs > 0 && state.deadlineMs <= nowMs)
+    state.deadlineMs = 0;
+
+  if (page != Dorf1)
+    return;
+
+  // İnşaat bittiğinde hem kaynak alanları (dorf1) hem de köy merkezi (dorf2)
+  // değişir - en erken biten inşaat için iki sayfaya da deadline koy
+  int earliest = -1;
+  const QVariantList queue = data["constructionQueue"].toList();
+  for (const QVariant &item : queue) {
+    int secs = parseDuration(item.toMap()["remainingTime"].toString());
+    if (secs >= 0 && (earliest < 0 || secs < earliest))
+      earliest = secs;
+  }
+
+  if (earliest >= 0) {
+    setDeadline(villageId, Dorf1 | Dorf2,
+                nowMs + earliest * 1000LL + DEADLINE_MARGIN_MS);
+  }
+}
+
+void RefreshPlanner::setDeadline(int villageId, int pageMask,
+                                 qint64 deadlineMs) {
+  for (Page page : {Dorf1, Dorf2, Barracks, Stable, Workshop}) {
+    if (!(pageMask & page))
+      continue;
+
+    PageState &state = m_pages[villageId][page];
+    // Bekleyen daha erken bir deadline varsa onu koru
+    if (state.deadlineMs == 0 || deadlineMs < state.deadlineMs ||
+        state.deadlineMs <= state.fetchedAtMs) {
+      state.deadlineMs = deadlineMs;
+    }
+  }
+}
+
+void RefreshPlanner::invalidate(int villageId, int pageMask) {
+  auto villageIt = m_pages.find(villageId);
+  if (villageIt == m_pages.end())
+    return;
+
+  for (Page page : {Dorf1, Dorf2, Barracks, Stable, Workshop}) {
+    if (pageMask & page)
+      villageIt->remove(page);
+  }
+}
+
+void RefreshPlanner::forgetVillage(int villageId) {
+  m_pages.remove(villageId);
+}
+
+void RefreshPlanner::resetStats() {
+  m_requestedCount = 0;
+  m_skippedCount = 0;
+}
@@ -0,0 +1,91 @@
+#ifndef REFRESHPLANNER_H
+#define REFRESHPLANNER_H
+
+#include <QHash>
+#include <QString>
+#include <QVariantMap>
+
+class VillageStore;
+
+/**
+ * @brief Decides which village pages actually need to be downloaded
+ *
+ * Every page of every village remembers when it was last fetched and,
+ * optionally, a deadline after which its content is known to change (e.g. a
+ * construction timer running out). A page is due when its deadline passed or
+ * when it got older than its maximum age. A periodic full sweep is kept as a
+ * safety net for changes we cannot predict (manual actions in the browser,
+ * research, ...).
+ */
+class RefreshPlanner {
+public:
+  enum Page {
+    NoPage = 0x00,
+    Dorf1 = 0x01,
+    Dorf2 = 0x02,
+    Barracks = 0x04,
+    Stable = 0x08,
+    Workshop = 0x10,
+    MilitaryPages = Barracks | Stable | Workshop,
+    AllPages = Dorf1 | Dorf2 | MilitaryPages
+  };
+
+  static Page pageFromName(const QString &pageName);
+  static QString pageName(Page page);
+  // Sayfanın kabul edilebilir maksimum yaşı
+  static qint64 maxAgeMs(Page page);
+
+  // Called once at the beginning of every full refresh cycle
+  void beginCycle(qint64 nowMs);
+  bool isFullSweep() const { return m_fullSweep; }
+  bool isFullSweepDue(qint64 nowMs) const;
+
+  bool isDue(int villageId, Page page, qint64 nowMs) const;
+  int duePages(int villageId, qint64 nowMs) const;
+
+  void markFetched(int villageId, const QString &pageName,
+                   const QVariantMap &data, qint64 nowMs);
+  void setDeadline(int villageId, int pageMask, qint64 deadlineMs);
+  void invalidate(int villageId, int pageMask);
+  void forgetVillage(int villageId);
+
+  // Statistics
+  void noteRequested(int count = 1) { m_requestedCount += count; }
+  void noteSkipped(int count = 1) { m_skippedCount += count; }
+  int requestedCount() const { return m_requestedCount; }
+  int skippedCount() const { return m_skippedCount; }
+  void resetStats();
+
+  static int parseDuration(const QString &hhmmss);
+
+  // VillageStore'un sayfa damgalarından (generation her kayıtta artar,
+  // içerik değişimini ayırt eder); sayfa yoksa 0
+  static quint64 newestGeneration(const VillageStore &store, int villageId,
+                                  int pageMask);
+  // pageMask içinde maxAgeMs'ten eski (ya da hiç çekilmemiş) sayfalar
+  static int stalePages(const VillageStore &store, int villageId, int pageMask,
+                        qint64 maxAgeMs, qint64 nowMs);
+
+private:
+  struct PageState {
+    qint64 fetchedAtMs = 0;
+    qint64 deadlineMs = 0; // 0 = no known deadline
+  };
+
+  QHash<int, QHash<int, PageState>> m_pages; // villageId -> page -> state
+  qint64 m_lastFullSweepMs = 0;
+  bool m_fullSweep = true;
+
+  int m_requestedCount = 0;
+  int m_skippedCount = 0;
+
+  // Sayfaların kabul edilebilir maksimum yaşı
+  static constexpr qint64 DORF1_MAX_AGE_MS = 3 * 60 * 1000;     // kaynaklar
+  static constexpr qint64 DORF2_MAX_AGE_MS = 30 * 60 * 1000;    // binalar
+  static constexpr qint64 MILITARY_MAX_AGE_MS = 2 * 3600 * 1000; // birlikler
+  static constexpr qint64 FULL_SWEEP_INTERVAL_MS = 60 * 60 * 1000;
+  // İnşaat bitişinden sonra sunucunun sayfayı güncellemesi için pay
+  static constexpr qint64 DEADLINE_MARGIN_MS = 5 * 1000;
+};
+
+#endif // REFRESHPLANNER_H
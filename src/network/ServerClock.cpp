@@ -0,0 +1,97 @@
+#include "src/network/ServerClock.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QRegularExpression>
+#include <algorithm>
+
+void ServerClock::addSample(qint64 sentAtMs, qint64 receivedAtMs,
+                            qint64 serverSeconds) {
+  if (serverSeconds < 0 || receivedAtMs < sentAtMs) {
+    return;
+  }
+
+  Sample sample;
+  sample.lowMs = serverSeconds * 1000 - receivedAtMs;
+  sample.highMs = serverSeconds * 1000 + 999 - sentAtMs;
+  sample.roundTripMs = receivedAtMs - sentAtMs;
+  sample.receivedAtMs = receivedAtMs;
+
+  // Süresi dolan ve fazla örnekleri at
+  while (!m_samples.isEmpty() &&
+         (m_samples.size() >= MAX_SAMPLES ||
+          receivedAtMs - m_samples.first().receivedAtMs > SAMPLE_MAX_AGE_MS)) {
+    m_samples.removeFirst();
+  }
+  m_samples.append(sample);
+
+  qint64 previousOffset = offsetMs();
+  bool wasSynced = m_samples.size() > 1;
+  recompute();
+
+  if (!wasSynced || qAbs(offsetMs() - previousOffset) > 1000) {
+    qDebug() << "[CLOCK] Server offset:" << offsetMs() << "ms (+/-"
+             << uncertaintyMs() << "ms), one-way delay:" << oneWayDelayMs()
+             << "ms";
+  }
+}
+
+void ServerClock::recompute() {
+  // En yeniden geriye kesişim; boşalırsa (saat atlaması) eski örnekler
+  // çelişiyordur ve atılır
+  m_lowMs = m_samples.last().lowMs;
+  m_highMs = m_samples.last().highMs;
+  for (int i = m_samples.size() - 2; i >= 0; --i) {
+    qint64 low = qMax(m_lowMs, m_samples[i].lowMs);
+    qint64 high = qMin(m_highMs, m_samples[i].highMs);
+    if (low > high) {
+      qDebug() << "[CLOCK] Inconsistent samples, dropping" << i + 1
+               << "older sample(s)";
+      m_samples.erase(m_samples.begin(), m_samples.begin() + i + 1);
+      break;
+    }
+    m_lowMs = low;
+    m_highMs = high;
+  }
+}
+
+qint64 ServerClock::oneWayDelayMs() const {
+  if (m_samples.isEmpty()) {
+    return 0;
+  }
+  QList<qint64> roundTrips;
+  for (const Sample &sample : m_samples) {
+    roundTrips.append(sample.roundTripMs);
+  }
+  auto middle = roundTrips.begin() + roundTrips.size() / 2;
+  std::nth_element(roundTrips.begin(), middle, roundTrips.end());
+  return *middle / 2;
+}
+
+qint64 ServerClock::serverNowMs() const {
+  return toServerMs(QDateTime::currentMSecsSinceEpoch());
+}
+
+qint64 ServerClock::pageTimeBaseMs(qint64 sentAtMs, qint64 receivedAtMs,
+                                   qint64 serverSeconds) const {
+  if (isSynced() && serverSeconds >= 0) {
+    return toLocalMs(serverSeconds * 1000);
+  }
+  return sentAtMs + (receivedAtMs - sentAtMs) / 2;
+}
+
+qint64 ServerClock::serverSecondsFromPage(const QString &html) {
+  // <div id="servertime" ...> Server saati: <span class="timer" value="...">
+  static const QRegularExpression regex(
+      "id=\"servertime\"[^>]*>[^<]*<span[^>]*value=\"(\\d+)\"");
+  QRegularExpressionMatch match = regex.match(html);
+  return match.hasMatch() ? match.captured(1).toLongLong() : -1;
+}
+
+qint64 ServerClock::serverSecondsFromDateHeader(const QByteArray &header) {
+  if (header.isEmpty()) {
+    return -1;
+  }
+  QDateTime date =
+      QDateTime::fromString(QString::fromLatin1(header), Qt::RFC2822Date);
+  return date.isValid() ? date.toSecsSinceEpoch() : -1;
+}
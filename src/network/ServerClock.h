@@ -0,0 +1,70 @@
+#ifndef SERVERCLOCK_H
+#define SERVERCLOCK_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Estimates the game server's clock offset from response timestamps
+ *
+ * Each response carries the server time in whole seconds: the page's
+ * "servertime" counter, or the HTTP Date header. The page was generated
+ * somewhere between sending the request and receiving the reply. So each
+ * sample bounds the offset (server - local) to
+ *   [S*1000 - receivedAt, S*1000 + 999 - sentAt].
+ * Intersecting the bounds of recent samples narrows the offset well below
+ * the one-second resolution of a single timestamp.
+ *
+ * Timers on a page ("h:mm:ss", value="...") count down to a whole server
+ * second. Anchoring them at toLocalMs(S * 1000) gives their absolute end on
+ * the local clock.
+ */
+class ServerClock {
+public:
+  // Sunucu saniyesi bilinmiyorsa (serverSeconds < 0) örnek eklenmez
+  void addSample(qint64 sentAtMs, qint64 receivedAtMs, qint64 serverSeconds);
+
+  // Sayfadaki "servertime" sayacı (sayfanın üretildiği saniye); yoksa -1
+  static qint64 serverSecondsFromPage(const QString &html);
+  // HTTP Date başlığı (RFC 2822); okunamazsa -1
+  static qint64 serverSecondsFromDateHeader(const QByteArray &header);
+
+  bool isSynced() const { return !m_samples.isEmpty(); }
+  qint64 offsetMs() const { return (m_lowMs + m_highMs) / 2; }
+  qint64 uncertaintyMs() const { return (m_highMs - m_lowMs) / 2; }
+  qint64 oneWayDelayMs() const;
+
+  qint64 serverNowMs() const;
+  qint64 toLocalMs(qint64 serverMs) const { return serverMs - offsetMs(); }
+  qint64 toServerMs(qint64 localMs) const { return localMs + offsetMs(); }
+
+  /**
+   * @brief Local instant the page's timers count from
+   * @param serverSeconds sayfanın sunucu saniyesi, bilinmiyorsa -1
+   * @return toLocalMs(serverSeconds * 1000) when synced, otherwise the
+   *         midpoint of the request's round trip
+   */
+  qint64 pageTimeBaseMs(qint64 sentAtMs, qint64 receivedAtMs,
+                        qint64 serverSeconds) const;
+
+private:
+  struct Sample {
+    qint64 lowMs = 0;  // offset alt sınırı
+    qint64 highMs = 0; // offset üst sınırı
+    qint64 roundTripMs = 0;
+    qint64 receivedAtMs = 0;
+  };
+
+  void recompute();
+
+  QList<Sample> m_samples; // en yeni sonda
+  qint64 m_lowMs = 0;
+  qint64 m_highMs = 0;
+
+  static constexpr int MAX_SAMPLES = 32;
+  // Yerel saat kayar; eski örnekler aralığı yanlış daraltmasın
+  static constexpr qint64 SAMPLE_MAX_AGE_MS = 30 * 60 * 1000;
+};
+
+#endif // SERVERCLOCK_H
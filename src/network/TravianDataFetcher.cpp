@@ -1,5 +1,7 @@
 #include "src/network/TravianDataFetcher.h"
+#include "src/models/UnitData.h"
 #include "src/parsers/HtmlParser.h"
+#include "src/parsers/OverviewParser.h"
 #include "src/parsers/VillageParser.h"
 #include <QCoreApplication>
 #include <QDateTime>
@@ -12,6 +14,7 @@
 #include <QNetworkCookie>
 #include <QNetworkCookieJar>
 #include <QRandomGenerator>
+#include <QSet>
 #include <QUrlQuery>
 #include <zlib.h>
 
@@ -312,6 +315,11 @@ bool TravianDataFetcher::loadConfig(const QString &configPath) {
                     "selector": "unit (u\\w+)[^>]*alt=\"([^\"]+)\"[\\s\\S]*?<td class=\"num\">(\\d+)</td>[\\s\\S]*?<td class=\"un\">([^<]+)</td>",
                     "type": "list",
                     "fields": ["unitClass", "unitName", "count", "displayName"]
+                },
+                "troopMovements": {
+                    "selector": "<span class=\"(a1|a2|d1|d2)\">(\\d+)&nbsp;[^<]*</span>[\\s\\S]*?<span\\s+class=\"timer\"[^>]*>(\\d+:\\d+:\\d+)</span>",
+                    "type": "list",
+                    "fields": ["movementClass", "count", "remainingTime"]
                 }
             }
         },
@@ -344,6 +352,11 @@ bool TravianDataFetcher::loadConfig(const QString &configPath) {
                     "selector": "action troop troopt(\\d+) empty",
                     "type": "list",
                     "fields": ["troopNum"]
+                },
+                "trainingQueue": {
+                    "selector": "<img class=\"unit u(\\d+)\"[^>]*alt=\"([^\"]*)\"[^>]*>\\s*(\\d+)[^<]*</td>\\s*<td class=\"dur\">\\s*<span\\s+class=\"timer\"[^>]*value=\"(\\d+)\"",
+                    "type": "list",
+                    "fields": ["unitId", "unitName", "count", "remainingSeconds"]
                 }
             }
         },
@@ -360,6 +373,11 @@ bool TravianDataFetcher::loadConfig(const QString &configPath) {
                     "selector": "action troop troopt(\\d+) empty",
                     "type": "list",
                     "fields": ["troopNum"]
+                },
+                "trainingQueue": {
+                    "selector": "<img class=\"unit u(\\d+)\"[^>]*alt=\"([^\"]*)\"[^>]*>\\s*(\\d+)[^<]*</td>\\s*<td class=\"dur\">\\s*<span\\s+class=\"timer\"[^>]*value=\"(\\d+)\"",
+                    "type": "list",
+                    "fields": ["unitId", "unitName", "count", "remainingSeconds"]
                 }
             }
         },
@@ -376,6 +394,11 @@ bool TravianDataFetcher::loadConfig(const QString &configPath) {
                     "selector": "action troop troopt(\\d+) empty",
                     "type": "list",
                     "fields": ["troopNum"]
+                },
+                "trainingQueue": {
+                    "selector": "<img class=\"unit u(\\d+)\"[^>]*alt=\"([^\"]*)\"[^>]*>\\s*(\\d+)[^<]*</td>\\s*<td class=\"dur\">\\s*<span\\s+class=\"timer\"[^>]*value=\"(\\d+)\"",
+                    "type": "list",
+                    "fields": ["unitId", "unitName", "count", "remainingSeconds"]
                 }
             }
         }
@@ -801,20 +824,42 @@ QString TravianDataFetcher::buildVillageUrl(const QString &pageUrl,
 void TravianDataFetcher::enqueuePageRequests(int villageId,
                                              const QString &villageName) {
   QJsonObject pages = m_config["pages"].toObject();
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
 
-  for (auto it = pages.begin(); it != pages.end(); ++it) {
-    QString pageName = it.key();
-    QJsonObject page = it.value().toObject();
+  // Sadece köy sayfaları burada sıraya girer. Askeri binalar slot ID'si
+  // gerektirdiği için dorf2 verisinden sonra
+  // enqueueMilitaryBuildingRequests ile eklenir.
+  for (const QString &pageName : {QString("dorf1"), QString("dorf2")}) {
+    if (!pages.contains(pageName)) {
+      continue;
+    }
+
+    RefreshPlanner::Page page = RefreshPlanner::pageFromName(pageName);
+    if (!m_refreshPlanner.isDue(villageId, page, now)) {
+      m_refreshPlanner.noteSkipped();
+      continue;
+    }
+
+    QJsonObject pageConfig = pages[pageName].toObject();
 
     PendingRequest req;
     req.pageName = pageName;
     req.villageId = villageId;
     req.villageName = villageName;
     req.isVillageListRequest = false;
-    req.pageConfig = page;
-    req.url = buildVillageUrl(page["url"].toString(), villageId);
+    req.pageConfig = pageConfig;
+    req.url = buildVillageUrl(pageConfig["url"].toString(), villageId);
 
     m_requestQueue.enqueue(req);
+    m_totalRequests++;
+    m_refreshPlanner.noteRequested();
+  }
+
+  // dorf2 güncel ise askeri binaları kayıtlı bina listesinden planla
+  if (!m_refreshPlanner.isDue(villageId, RefreshPlanner::Dorf2, now)) {
+    QVariantMap dorf2 = m_villageStore.page(villageId, "dorf2");
+    enqueueMilitaryBuildingRequests(villageId, villageName, dorf2);
+    reportIncomingAttacks(villageId);
   }
 }
 
@@ -822,22 +867,14 @@ void TravianDataFetcher::storeVillageData(int villageId,
                                           const QString &villageName,
                                           const QString &pageName,
                                           const QVariantMap &data) {
-  QString villageKey = "village_" + QString::number(villageId);
-  QVariantMap villageData = m_collectedData.value(villageKey).toMap();
-
-  villageData[pageName] = data;
-  villageData["villageName"] = villageName;
-  villageData["villageId"] = villageId;
-
-  m_collectedData[villageKey] = villageData;
-
-  // Update village list as well
-  for (int i = 0; i < m_villages.size(); ++i) {
-    if (m_villages[i].id == villageId) {
-      m_villages[i].data = villageData;
-      break;
-    }
-  }
+  // Sayfa süreleri sunucu saatine göre hizalı taban andan sayılır
+  qint64 now = m_pageTimeBaseMs > 0 ? m_pageTimeBaseMs
+                                    : QDateTime::currentMSecsSinceEpoch();
+  m_refreshPlanner.markFetched(villageId, pageName, data, now);
+
+  // Sadece bu sayfanın hücresi yazılır; köyün diğer sayfaları kopyalanmaz
+  m_villageStore.storePage(villageId, villageName, pageName, data, now,
+                           ++m_pageGeneration);
 }
 
 void TravianDataFetcher::logPageData(const QString &pageName,
@@ -855,21 +892,31 @@ void TravianDataFetcher::logPageData(const QString &pageName,
 // ============================================================================
 
 void TravianDataFetcher::fetchAllVillagesData() {
+  // İlk köyün ID'sini sakla: liste isteği bu köyün dorf1 sayfası olarak da
+  // kullanılıyor, newdid olmadan sunucu en son aktif köyü döndürür
+  int firstVillageId = m_villages.isEmpty() ? -1 : m_villages.first().id;
+
   m_villages.clear();
   m_currentVillageIndex = 0;
-  m_collectedData.clear();
-  m_requestQueue.clear();
+  clearRequestQueue();
+  m_fullCycleActive = true;
+
+  // m_villageStore temizlenmez: planlayıcının atladığı sayfalar önceki
+  // döngünün verisiyle kalır
+  m_refreshPlanner.resetStats();
+  m_refreshPlanner.beginCycle(QDateTime::currentMSecsSinceEpoch());
 
   // First, fetch village list from dorf1.php
   PendingRequest req;
   req.pageName = "_villageList";
-  req.url = m_baseUrl + "/dorf1.php";
+  req.url = buildVillageUrl("/dorf1.php", firstVillageId);
   req.isVillageListRequest = true;
   req.villageId = -1;
 
-  m_totalRequests = 1;
+  m_totalRequests = m_requestQueue.size() + 1;
   m_completedRequests = 0;
   m_requestQueue.enqueue(req);
+  enqueueTroopOverviewRequest();
 
   processNextRequest();
 }
@@ -882,9 +929,10 @@ void TravianDataFetcher::fetchVillageData(int villageId,
 void TravianDataFetcher::fetchAllData() {
   QJsonObject pages = m_config["pages"].toObject();
 
-  m_totalRequests = pages.size();
+  clearRequestQueue();
+  m_totalRequests = m_requestQueue.size() + pages.size();
   m_completedRequests = 0;
-  m_requestQueue.clear();
+  m_fullCycleActive = true;
 
   for (auto it = pages.begin(); it != pages.end(); ++it) {
     QString pageName = it.key();
@@ -912,9 +960,10 @@ void TravianDataFetcher::fetchPage(const QString &pageName, int villageId) {
 
   QJsonObject page = pages[pageName].toObject();
 
-  m_totalRequests = 1;
+  clearRequestQueue();
+  m_totalRequests = m_requestQueue.size() + 1;
   m_completedRequests = 0;
-  m_requestQueue.clear();
+  m_fullCycleActive = true;
 
   PendingRequest req;
   req.pageName = pageName;
@@ -927,9 +976,245 @@ void TravianDataFetcher::fetchPage(const QString &pageName, int villageId) {
   processNextRequest();
 }
 
+void TravianDataFetcher::fetchAccountOverview() {
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  // İlk yüklemede ve saatlik tam taramada köy sayfalarının hepsi zaten
+  // çekileceği için genel bakışa gerek yok
+  if (m_villages.isEmpty() || m_refreshPlanner.isFullSweepDue(now)) {
+    fetchAllVillagesData();
+    return;
+  }
+
+  m_currentVillageIndex = 0;
+  clearRequestQueue();
+  m_overviewRows.clear();
+  m_fullCycleActive = true;
+
+  m_refreshPlanner.resetStats();
+  m_refreshPlanner.beginCycle(now);
+
+  // Önce kaynaklar (Plus gerektirir), sonra köy listesi + inşaatlar.
+  // Köy bazlı sayfalar son istek işlendikten sonra planlayıcıya göre eklenir.
+  PendingRequest resourcesReq;
+  resourcesReq.pageName = "_overviewResources";
+  resourcesReq.url = m_baseUrl + "/dorf3.php?s=2";
+  resourcesReq.villageId = -1;
+
+  PendingRequest overviewReq;
+  overviewReq.pageName = "_overview";
+  overviewReq.url = m_baseUrl + "/dorf3.php";
+  overviewReq.villageId = -1;
+
+  m_totalRequests = m_requestQueue.size() + 2;
+  m_completedRequests = 0;
+  m_requestQueue.enqueue(resourcesReq);
+  m_requestQueue.enqueue(overviewReq);
+  m_refreshPlanner.noteRequested(2);
+  enqueueTroopOverviewRequest();
+
+  processNextRequest();
+}
+
+void TravianDataFetcher::clearRequestQueue() {
+  // Tam döngü bekleyen hedefli yenilemeleri de kapsar, ama kullanıcının
+  // seçtiği köyün (öncelikli) istekleri atılırsa villageRefreshed hiç
+  // gelmez; onlar kuyruğun önünde kalır. Gönderilmiş isteklerin sayacı da
+  // korunur, yanıtları geldiğinde düşer
+  QQueue<PendingRequest> kept;
+  for (const PendingRequest &req : std::as_const(m_requestQueue)) {
+    if (req.isPriority) {
+      kept.enqueue(req);
+      continue;
+    }
+    if (!req.isTargeted) {
+      continue;
+    }
+    auto pending = m_targetedPending.find(req.villageId);
+    if (pending != m_targetedPending.end() && --pending.value() <= 0) {
+      m_targetedPending.erase(pending);
+    }
+  }
+  m_requestQueue = kept;
+}
+
+void TravianDataFetcher::enqueueTroopOverviewRequest() {
+  if (!m_troopOverviewEnabled) {
+    return;
+  }
+
+  PendingRequest req;
+  req.pageName = "_overviewTroops";
+  req.url = m_baseUrl + "/dorf3.php?s=5";
+  req.villageId = -1;
+
+  m_requestQueue.enqueue(req);
+  m_totalRequests++;
+  m_refreshPlanner.noteRequested();
+}
+
+QVariantMap TravianDataFetcher::getAllData() const {
+  QVariantMap allData = m_accountData;
+  m_villageStore.writeTo(allData);
+  return allData;
+}
+
+QList<VillageInfo> TravianDataFetcher::getVillages() const {
+  QList<VillageInfo> villages = m_villages;
+  for (VillageInfo &v : villages) {
+    v.data = m_villageStore.villageData(v.id);
+  }
+  return villages;
+}
+
 QVariantMap TravianDataFetcher::getVillageData(int villageId) const {
-  QString key = "village_" + QString::number(villageId);
-  return m_collectedData.value(key).toMap();
+  return m_villageStore.villageData(villageId);
+}
+
+bool TravianDataFetcher::refreshVillage(int villageId, int pageMask,
+                                        bool priority) {
+  QString villageName;
+  for (const VillageInfo &v : m_villages) {
+    if (v.id == villageId) {
+      villageName = v.name;
+      break;
+    }
+  }
+  if (villageName.isEmpty()) {
+    qDebug() << "[REFRESH] Unknown village, skipping targeted refresh:"
+             << villageId;
+    return false;
+  }
+
+  // Askeri binalar: 19=Kışla, 20=Ahır, 21=Atölye
+  QMap<RefreshPlanner::Page, int> militaryGids;
+  militaryGids[RefreshPlanner::Barracks] = 19;
+  militaryGids[RefreshPlanner::Stable] = 20;
+  militaryGids[RefreshPlanner::Workshop] = 21;
+
+  QJsonObject pages = m_config["pages"].toObject();
+  int queued = 0;
+  int promoted = 0;
+  int alreadyPriority = 0; // önceki seçimden, hâlâ önde bekliyor
+
+  for (RefreshPlanner::Page page :
+       {RefreshPlanner::Dorf1, RefreshPlanner::Dorf2, RefreshPlanner::Barracks,
+        RefreshPlanner::Stable, RefreshPlanner::Workshop}) {
+    if (!(pageMask & page)) {
+      continue;
+    }
+
+    QString pageName = RefreshPlanner::pageName(page);
+    if (!pages.contains(pageName)) {
+      continue;
+    }
+
+    // Öncelikli istekler sırayla kuyruğun başında durur
+    int priorityEnd = 0;
+    while (priorityEnd < m_requestQueue.size() &&
+           m_requestQueue[priorityEnd].isPriority) {
+      priorityEnd++;
+    }
+
+    // Aynı sayfa zaten kuyruktaysa tekrar ekleme; öncelikliyse öne al
+    bool alreadyQueued = false;
+    for (int i = 0; i < m_requestQueue.size(); ++i) {
+      PendingRequest &pending = m_requestQueue[i];
+      if (pending.villageId != villageId || pending.pageName != pageName) {
+        continue;
+      }
+      alreadyQueued = true;
+      if (priority && !pending.isPriority) {
+        PendingRequest moved = m_requestQueue.takeAt(i);
+        moved.isPriority = true;
+        m_requestQueue.insert(priorityEnd, moved);
+        promoted++;
+      } else if (priority) {
+        alreadyPriority++;
+      }
+      break;
+    }
+    if (alreadyQueued) {
+      continue;
+    }
+
+    QJsonObject pageConfig = pages[pageName].toObject();
+    QString url;
+    if (militaryGids.contains(page)) {
+      int slotId = findBuildingSlot(villageId, militaryGids[page]);
+      if (slotId < 0) {
+        continue;
+      }
+      url = buildVillageUrl("/build.php?id=" + QString::number(slotId),
+                            villageId);
+    } else {
+      url = buildVillageUrl(pageConfig["url"].toString(), villageId);
+    }
+
+    PendingRequest req;
+    req.pageName = pageName;
+    req.pageConfig = pageConfig;
+    req.villageId = villageId;
+    req.villageName = villageName;
+    req.isVillageListRequest = false;
+    req.isTargeted = true;
+    req.isPriority = priority;
+    req.url = url;
+
+    if (priority) {
+      m_requestQueue.insert(priorityEnd, req);
+    } else {
+      m_requestQueue.enqueue(req);
+    }
+    queued++;
+  }
+
+  if (queued == 0) {
+    if (promoted > 0) {
+      qDebug() << "[REFRESH] Moved" << promoted << "queued page(s) of village"
+               << villageId << "to the front";
+    } else {
+      qDebug() << "[REFRESH] Nothing to refresh for village" << villageId
+               << "mask:" << pageMask;
+    }
+    return promoted > 0 || alreadyPriority > 0;
+  }
+
+  qDebug() << "[REFRESH] Targeted refresh for village" << villageId
+           << "-" << queued << "page(s), mask:" << pageMask
+           << (priority ? "[priority]" : "");
+
+  m_targetedPending[villageId] += queued;
+  m_totalRequests += queued;
+  processNextRequest();
+  return true;
+}
+
+void TravianDataFetcher::finishTargetedRequest(int villageId) {
+  auto it = m_targetedPending.find(villageId);
+  if (it == m_targetedPending.end()) {
+    return;
+  }
+
+  if (--it.value() > 0) {
+    return;
+  }
+
+  m_targetedPending.erase(it);
+  emit villageRefreshed(villageId, getVillageData(villageId));
+}
+
+int TravianDataFetcher::findBuildingSlot(int villageId, int gid) const {
+  QVariantMap dorf2 = m_villageStore.page(villageId, "dorf2");
+  const QVariantList buildings = dorf2["buildings"].toList();
+
+  for (const QVariant &building : buildings) {
+    QVariantMap b = building.toMap();
+    if (b["gid"].toInt() == gid) {
+      return b["slotId"].toInt();
+    }
+  }
+  return -1;
 }
 
 // ============================================================================
@@ -937,7 +1222,27 @@ QVariantMap TravianDataFetcher::getVillageData(int villageId) const {
 // ============================================================================
 
 void TravianDataFetcher::upgradeBuilding(int villageId, int slotId) {
+  // İnşaat bitmeden önce çekilmiş sayfadan link varsa sayfayı tekrar açma
+  QString linkKey = QString("%1_%2").arg(villageId).arg(slotId);
+  UpgradeLinkCacheEntry cached = m_upgradeLinks.take(linkKey);
+  if (!cached.url.isEmpty() &&
+      QDateTime::currentMSecsSinceEpoch() - cached.fetchedAtMs <
+          UPGRADE_LINK_TTL_MS) {
+    qDebug() << "[UPGRADE] Using prefetched link for village" << villageId
+             << "slot" << slotId;
+    sendUpgradeRequest(villageId, slotId, cached.url, cached.buildingName);
+    return;
+  }
+
+  requestBuildPage(villageId, slotId, "getBuildPage");
+}
+
+void TravianDataFetcher::prefetchBuildPage(int villageId, int slotId) {
+  requestBuildPage(villageId, slotId, "prefetch");
+}
 
+void TravianDataFetcher::requestBuildPage(int villageId, int slotId,
+                                          const QString &upgradeStep) {
   // Önce bina sayfasını aç (upgrade butonunu ve gerekli parametreleri almak
   // için)
   QString buildUrl = m_baseUrl + "/build.php?id=" + QString::number(slotId);
@@ -955,7 +1260,8 @@ void TravianDataFetcher::upgradeBuilding(int villageId, int slotId) {
 
   QNetworkReply *reply = m_networkManager->get(request);
   reply->setProperty("isUpgradeRequest", true);
-  reply->setProperty("upgradeStep", "getBuildPage");
+  reply->setProperty("upgradeStep", upgradeStep);
+  reply->setProperty("sentAtMs", QDateTime::currentMSecsSinceEpoch());
   reply->setProperty("villageId", villageId);
   reply->setProperty("slotId", slotId);
 
@@ -963,6 +1269,101 @@ void TravianDataFetcher::upgradeBuilding(int villageId, int slotId) {
           [this, reply]() { onUpgradeFinished(reply); });
 }
 
+QString TravianDataFetcher::findUpgradeUrl(const QString &page, int villageId,
+                                           int slotId,
+                                           bool allowBusyBuilder) const {
+  // Upgrade linkini bul - yeni format: onclick içinde window.location.href
+  // Format: onclick="this.disabled = true; window.location.href =
+  // '/dorf2.php?id=34&amp;gid=19&amp;action=build&amp;checksum=74dc4a';
+  // return false;"
+  QRegularExpression upgradeRegex(
+      R"(class=\"[^\"]*green[^\"]*build[^\"]*\"[^>]*onclick=\"[^\"]*window\.location\.href\s*=\s*'([^']+)')");
+  QRegularExpressionMatch match = upgradeRegex.match(page);
+
+  if (!match.hasMatch()) {
+    // Fallback 1: Eski format - build.php?id=X&a=X&c=CHECKSUM
+    QRegularExpression oldRegex(
+        R"(build\.php\?id=(\d+)[^\"]*&amp;a=\d+[^\"]*&amp;c=([a-f0-9]+))");
+    match = oldRegex.match(page);
+
+    if (!match.hasMatch()) {
+      // Fallback 2: href attribute
+      QRegularExpression hrefRegex(
+          R"(href=\"(/build\.php\?id=\d+[^\"]*a=\d+[^\"]*c=[a-f0-9]+)\")");
+      match = hrefRegex.match(page);
+    }
+  }
+
+  QString capturedUrl;
+  if (match.hasMatch()) {
+    capturedUrl = match.captured(1);
+  } else if (allowBusyBuilder) {
+    // İnşaatçı meşgulken yeşil buton yok, ama yapı ustası butonu aynı
+    // checksum ile normal inşa linkini taşır (&buildmaster olmadan)
+    QRegularExpression builderRegex(
+        R"(class=\"[^\"]*gold builder[^\"]*\"[^>]*onclick=\"[^\"]*window\.location\.href\s*=\s*'([^']+action=build[^']+)')");
+    QRegularExpressionMatch builderMatch = builderRegex.match(page);
+    if (builderMatch.hasMatch()) {
+      capturedUrl = builderMatch.captured(1).remove("&amp;buildmaster");
+    }
+  }
+
+  if (capturedUrl.isEmpty()) {
+    return QString();
+  }
+
+  QString upgradeUrl;
+  // If captured URL starts with /, it's relative
+  if (capturedUrl.startsWith("/")) {
+    upgradeUrl = m_baseUrl + capturedUrl.replace("&amp;", "&");
+  } else if (capturedUrl.contains("build.php") ||
+             capturedUrl.contains("dorf2.php")) {
+    // Full or partial URL captured
+    upgradeUrl = m_baseUrl + "/" + capturedUrl.replace("&amp;", "&");
+  } else {
+    // Fallback: construct URL manually (shouldn't happen with new regex)
+    upgradeUrl = m_baseUrl + "/build.php?id=" + QString::number(slotId);
+  }
+
+  // Köy ID'sini upgrade URL'sine ekle (farklı köy için upgrade yapabilmek
+  // için)
+  if (villageId > 0 && !upgradeUrl.contains("newdid")) {
+    upgradeUrl += "&newdid=" + QString::number(villageId);
+  }
+  return upgradeUrl;
+}
+
+void TravianDataFetcher::sendUpgradeRequest(int villageId, int slotId,
+                                            const QString &upgradeUrl,
+                                            const QString &buildingName) {
+  qDebug() << "[UPGRADE] villageId:" << villageId << "slotId:" << slotId
+           << "buildingName:" << buildingName << "upgradeUrl:" << upgradeUrl;
+
+  // Upgrade isteği gönder
+  QNetworkRequest request;
+  request.setUrl(QUrl(upgradeUrl));
+
+  // Oturum boyunca sabit UA (gerçek tarayıcı gibi)
+  request.setRawHeader("User-Agent", m_sessionUserAgent.toUtf8());
+
+  QString refererUrl = m_baseUrl + "/build.php?id=" + QString::number(slotId);
+  if (villageId > 0) {
+    refererUrl += "&newdid=" + QString::number(villageId);
+  }
+  request.setRawHeader("Referer", refererUrl.toUtf8());
+
+  QNetworkReply *upgradeReply = m_networkManager->get(request);
+  upgradeReply->setProperty("isUpgradeRequest", true);
+  upgradeReply->setProperty("upgradeStep", "doUpgrade");
+  upgradeReply->setProperty("sentAtMs", QDateTime::currentMSecsSinceEpoch());
+  upgradeReply->setProperty("villageId", villageId);
+  upgradeReply->setProperty("slotId", slotId);
+  upgradeReply->setProperty("buildingName", buildingName);
+
+  connect(upgradeReply, &QNetworkReply::finished, this,
+          [this, upgradeReply]() { onUpgradeFinished(upgradeReply); });
+}
+
 void TravianDataFetcher::onUpgradeFinished(QNetworkReply *reply) {
   QString upgradeStep = reply->property("upgradeStep").toString();
   int villageId = reply->property("villageId").toInt();
@@ -970,8 +1371,14 @@ void TravianDataFetcher::onUpgradeFinished(QNetworkReply *reply) {
 
   if (reply->error() != QNetworkReply::NoError) {
     QString error = reply->errorString();
-    emit upgradeFailed(villageId, slotId, error);
     reply->deleteLater();
+    if (upgradeStep == "prefetch") {
+      // Ön yükleme başarısızsa asıl yükseltme sayfayı kendisi açar
+      qDebug() << "[UPGRADE] Prefetch failed for village" << villageId
+               << "slot" << slotId << ":" << error;
+      return;
+    }
+    emit upgradeFailed(villageId, slotId, error);
     return;
   }
 
@@ -981,10 +1388,13 @@ void TravianDataFetcher::onUpgradeFinished(QNetworkReply *reply) {
   int statusCode =
       reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
+  qint64 timeBaseMs = observeServerTime(reply, response);
+  // Yönlendirme sonrası son adres (doUpgrade -> dorf1.php / dorf2.php)
+  QString finalPath = reply->url().path();
   refreshCookiesFromResponse(reply);
   reply->deleteLater();
 
-  if (upgradeStep == "getBuildPage") {
+  if (upgradeStep == "getBuildPage" || upgradeStep == "prefetch") {
     // Bina adını bul
     QRegularExpression nameRegex(
         R"(<h1[^>]*class=\"titleInHeader\"[^>]*>([^<]+)</h1>)");
@@ -992,99 +1402,66 @@ void TravianDataFetcher::onUpgradeFinished(QNetworkReply *reply) {
     QString buildingName =
         nameMatch.hasMatch() ? nameMatch.captured(1).trimmed() : "Bina";
 
-    // Upgrade linkini bul - yeni format: onclick içinde window.location.href
-    // Format: onclick="this.disabled = true; window.location.href =
-    // '/dorf2.php?id=34&amp;gid=19&amp;action=build&amp;checksum=74dc4a';
-    // return false;"
-    QRegularExpression upgradeRegex(
-        R"(class=\"[^\"]*green[^\"]*build[^\"]*\"[^>]*onclick=\"[^\"]*window\.location\.href\s*=\s*'([^']+)')");
-    QRegularExpressionMatch match = upgradeRegex.match(response);
+    bool prefetch = upgradeStep == "prefetch";
+    QString upgradeUrl =
+        findUpgradeUrl(response, villageId, slotId, prefetch);
 
-    if (!match.hasMatch()) {
-      // Fallback 1: Eski format - build.php?id=X&a=X&c=CHECKSUM
-      QRegularExpression oldRegex(
-          R"(build\.php\?id=(\d+)[^\"]*&amp;a=\d+[^\"]*&amp;c=([a-f0-9]+))");
-      match = oldRegex.match(response);
-
-      if (!match.hasMatch()) {
-        // Fallback 2: href attribute
-        QRegularExpression hrefRegex(
-            R"(href=\"(/build\.php\?id=\d+[^\"]*a=\d+[^\"]*c=[a-f0-9]+)\")");
-        match = hrefRegex.match(response);
+    if (prefetch) {
+      if (upgradeUrl.isEmpty()) {
+        qDebug() << "[UPGRADE] Prefetch found no build link for village"
+                 << villageId << "slot" << slotId;
+        return;
       }
+      UpgradeLinkCacheEntry entry;
+      entry.url = upgradeUrl;
+      entry.buildingName = buildingName;
+      entry.fetchedAtMs = QDateTime::currentMSecsSinceEpoch();
+      m_upgradeLinks.insert(QString("%1_%2").arg(villageId).arg(slotId),
+                            entry);
+      qDebug() << "[UPGRADE] Prefetched build link for village" << villageId
+               << "slot" << slotId;
+      return;
     }
 
-    if (!match.hasMatch()) {
+    if (upgradeUrl.isEmpty()) {
       emit upgradeFailed(
           villageId, slotId,
           "Yükseltme linki bulunamadı - yeterli kaynak yok olabilir");
       return;
     }
 
-    QString upgradeUrl;
-    QString capturedUrl = match.captured(1);
-
-    // If captured URL starts with /, it's relative
-    if (capturedUrl.startsWith("/")) {
-      upgradeUrl = m_baseUrl + capturedUrl.replace("&amp;", "&");
-    } else if (capturedUrl.contains("build.php") ||
-               capturedUrl.contains("dorf2.php")) {
-      // Full or partial URL captured
-      upgradeUrl = m_baseUrl + "/" + capturedUrl.replace("&amp;", "&");
-    } else {
-      // Fallback: construct URL manually (shouldn't happen with new regex)
-      upgradeUrl = m_baseUrl + "/build.php?id=" + QString::number(slotId);
-    }
-
-    // Köy ID'sini upgrade URL'sine ekle (farklı köy için upgrade yapabilmek
-    // için)
-    if (villageId > 0 && !upgradeUrl.contains("newdid")) {
-      upgradeUrl += "&newdid=" + QString::number(villageId);
-    }
-
-    qDebug() << "[UPGRADE] villageId:" << villageId << "slotId:" << slotId
-             << "buildingName:" << buildingName << "upgradeUrl:" << upgradeUrl;
-
-    // Upgrade isteği gönder
-    QNetworkRequest request;
-    request.setUrl(QUrl(upgradeUrl));
-
-    // Oturum boyunca sabit UA (gerçek tarayıcı gibi)
-    request.setRawHeader("User-Agent", m_sessionUserAgent.toUtf8());
-
-    QString refererUrl = m_baseUrl + "/build.php?id=" + QString::number(slotId);
-    if (villageId > 0) {
-      refererUrl += "&newdid=" + QString::number(villageId);
-    }
-    request.setRawHeader("Referer", refererUrl.toUtf8());
-
-    QNetworkReply *upgradeReply = m_networkManager->get(request);
-    upgradeReply->setProperty("isUpgradeRequest", true);
-    upgradeReply->setProperty("upgradeStep", "doUpgrade");
-    upgradeReply->setProperty("villageId", villageId);
-    upgradeReply->setProperty("slotId", slotId);
-    upgradeReply->setProperty("buildingName", buildingName);
-
-    connect(upgradeReply, &QNetworkReply::finished, this,
-            [this, upgradeReply]() { onUpgradeFinished(upgradeReply); });
+    sendUpgradeRequest(villageId, slotId, upgradeUrl, buildingName);
     return;
   }
 
   if (upgradeStep == "doUpgrade") {
     QString buildingName = reply->property("buildingName").toString();
 
-    // Başarı kontrolü - inşaat kuyruğuna eklenmiş mi?
-    if (response.contains("buildingList") ||
-        response.contains("constructionQueue") ||
-        response.contains("buildDuration") ||
-        response.contains("class=\"timer\"")) {
-      emit upgradeStarted(villageId, slotId, buildingName);
-    } else if (response.contains("notEnough") ||
-               response.contains("enough resources")) {
+    if (response.contains("notEnough") ||
+        response.contains("enough resources")) {
+      m_refreshPlanner.invalidate(villageId, RefreshPlanner::Dorf1);
       emit upgradeFailed(villageId, slotId, "Yeterli kaynak yok");
-    } else {
-      // Genelde başarılı olduğunda dorf1 veya build sayfasına yönlendirir
-      emit upgradeStarted(villageId, slotId, buildingName);
+      return;
+    }
+
+    // Yükseltme dorf1/dorf2'ye yönlendirir: yanıt kaynak çubuğunu taşır.
+    // İnşaat kuyruğu yalnızca dorf1 ayrıştırmasında var; köy merkezi
+    // binalarında (dorf2) dorf1 ayrıca yenilenmeli
+    QString pageName = finalPath.contains("dorf1")   ? "dorf1"
+                       : finalPath.contains("dorf2") ? "dorf2"
+                                                     : QString();
+    bool absorbed =
+        !pageName.isEmpty() &&
+        absorbActionResponse(villageId, pageName, response, timeBaseMs);
+    bool villageUpdated = absorbed && pageName == "dorf1";
+    if (!villageUpdated) {
+      // İnşaat kuyruğu değişti - bir sonraki döngüde dorf1 kesin çekilsin
+      m_refreshPlanner.invalidate(villageId, RefreshPlanner::Dorf1);
+    }
+
+    emit upgradeStarted(villageId, slotId, buildingName, villageUpdated);
+    if (villageUpdated) {
+      emit villageRefreshed(villageId, getVillageData(villageId));
     }
   }
 }
@@ -1095,10 +1472,28 @@ void TravianDataFetcher::onUpgradeFinished(QNetworkReply *reply) {
 
 void TravianDataFetcher::trainTroops(int villageId, int slotId,
                                      const QString &troopId,
-                                     const QString &troopName) {
+                                     const QString &troopName,
+                                     int trainSeconds) {
   qDebug() << "[TROOP] trainTroops called - village:" << villageId
            << "slot:" << slotId << "troop:" << troopId << "name:" << troopName;
 
+  // Önceki POST yanıtı formun tamamını (checksum dahil) içerir: tazeyse
+  // sayfayı yeniden çekmeden doğrudan gönder
+  QString formKey = QString("%1_%2").arg(villageId).arg(slotId);
+  auto cachedForm = m_trainingForms.constFind(formKey);
+  if (cachedForm != m_trainingForms.constEnd()) {
+    qint64 ageMs = QDateTime::currentMSecsSinceEpoch() - cachedForm->storedAtMs;
+    if (ageMs < TRAIN_FORM_TTL_MS) {
+      qDebug() << "[TROOP] Using cached training form (" << ageMs / 1000
+               << "s old)";
+      postTrainingForm(villageId, slotId, troopId, troopName, trainSeconds,
+                       cachedForm->html, true,
+                       static_cast<int>(ageMs / 1000));
+      return;
+    }
+    m_trainingForms.remove(formKey);
+  }
+
   // Step 1: Fetch the barracks/stable/workshop page
   QString buildUrl = m_baseUrl + "/build.php?id=" + QString::number(slotId);
   if (villageId > 0) {
@@ -1113,207 +1508,412 @@ void TravianDataFetcher::trainTroops(int villageId, int slotId,
   QNetworkReply *reply = m_networkManager->get(request);
   reply->setProperty("isTrainRequest", true);
   reply->setProperty("trainStep", "getPage");
+  reply->setProperty("sentAtMs", QDateTime::currentMSecsSinceEpoch());
   reply->setProperty("villageId", villageId);
   reply->setProperty("slotId", slotId);
   reply->setProperty("troopId", troopId);
   reply->setProperty("troopName", troopName);
+  reply->setProperty("trainSeconds", trainSeconds);
 
   connect(reply, &QNetworkReply::finished, this,
           [this, reply]() { onTrainTroopFinished(reply); });
 }
 
-void TravianDataFetcher::onTrainTroopFinished(QNetworkReply *reply) {
-  QString trainStep = reply->property("trainStep").toString();
-  int villageId = reply->property("villageId").toInt();
-  int slotId = reply->property("slotId").toInt();
-  QString troopId = reply->property("troopId").toString();
-
-  if (reply->error() != QNetworkReply::NoError) {
-    QString error = reply->errorString();
-    qWarning() << "[TROOP] Network error:" << error;
-    emit troopTrainingResult(villageId, false, troopId, 0,
-                             "Ağ hatası: " + error);
-    reply->deleteLater();
-    return;
+int TravianDataFetcher::trainingQueueEnd(const QString &page) {
+  // Eğitimdeki satırların sayaçları kümülatiftir: en büyüğü kuyruğun sonu
+  int queueSeconds = 0;
+  static const QRegularExpression queueTimerRegex(
+      R"~~(class="dur">\s*<span\s+class="timer"[^>]*value="(\d+)")~~");
+  QRegularExpressionMatchIterator queueIt = queueTimerRegex.globalMatch(page);
+  while (queueIt.hasNext()) {
+    queueSeconds = qMax(queueSeconds, queueIt.next().captured(1).toInt());
   }
+  return queueSeconds;
+}
 
-  QByteArray rawData = reply->readAll();
-  rawData = decompressGzip(rawData);
-  QString response = QString::fromUtf8(rawData);
-
-  refreshCookiesFromResponse(reply);
-  reply->deleteLater();
+int TravianDataFetcher::unitTrainingSeconds(const QString &page,
+                                            const QString &inputName) {
+  // Birim eğitim süresi, birliğin girdi kutusundan önceki "duration"
+  // bloğunda (bina seviyesi ve bonuslar dahil)
+  int inputPos = page.indexOf(QString("name=\"%1\"").arg(inputName));
+  int durationPos =
+      inputPos > 0 ? page.lastIndexOf("duration\" title=", inputPos) : -1;
+  if (durationPos < 0) {
+    return 0;
+  }
+
+  static const QRegularExpression durationRegex(
+      R"~~((\d+):(\d{2}):(\d{2}))~~");
+  QRegularExpressionMatch durationMatch =
+      durationRegex.match(page.mid(durationPos, inputPos - durationPos));
+  if (!durationMatch.hasMatch()) {
+    return 0;
+  }
+  return durationMatch.captured(1).toInt() * 3600 +
+         durationMatch.captured(2).toInt() * 60 +
+         durationMatch.captured(3).toInt();
+}
 
-  if (trainStep == "getPage") {
-    qDebug() << "[TROOP] Got building page, parsing for troop:" << troopId;
+ResourceSnapshot
+TravianDataFetcher::trainingPageSnapshot(int villageId, const QString &page,
+                                         int pageAgeSeconds) const {
+  // Üretim ve kapasite dorf1'den, stok sayfanın kaynak çubuğundan
+  ResourceSnapshot snapshot = m_villageStore.resources(villageId);
 
-    // Save debug HTML
-    QFile debugFile("/Users/kekinci/Desktop/test/config/debug_train_page.html");
-    if (debugFile.open(QIODevice::WriteOnly)) {
-      debugFile.write(response.toUtf8());
-      debugFile.close();
-    }
+  int stock[ResourceSnapshot::ResourceCount] = {};
+  if (!parseStockBar(page, stock)) {
+    return ResourceSnapshot();
+  }
 
-    // Extract troop number from troopId (e.g., "t1" -> "1", "t3" -> "3")
-    // Also handle global IDs (e.g. "u11" -> "t1", "u21" -> "t1")
-    QString inputName = troopId;
-    if (troopId.startsWith("u")) {
-      int gid = troopId.mid(1).toInt();
-      int rid = (gid - 1) % 10 + 1;
-      inputName = "t" + QString::number(rid);
-      qDebug() << "[TROOP] Converted global ID" << troopId
-               << "to relative input" << inputName;
-    } else if (troopId.startsWith("t")) {
-      // Already relative or old format
-      inputName = troopId;
-    }
+  snapshot.setStock(stock, QDateTime::currentMSecsSinceEpoch() -
+                               qint64(pageAgeSeconds) * 1000);
+  return snapshot;
+}
 
-    // Use troop name from config (passed via property), fallback to troopId
-    QString troopName = reply->property("troopName").toString();
-    if (troopName.isEmpty()) {
-      troopName = troopId;
-    }
-    qDebug() << "[TROOP] Using troop name:" << troopName;
-
-    // Find the max trainable count for this troop
-    // HTML structure inside <div class="cta">:
-    //   <input name="t1" value="0" />
-    //   <span> / </span>
-    //   <a href="#" onclick="...val(11)...">11</a>
-    // The input and max link are very close together, within ~200 chars
-    int maxCount = 0;
-
-    // Pattern 1: Find name="t1" input, then the very next .val(N) within same
-    // cta block Use [\s\S] instead of . to match across newlines, with negative
-    // lookahead to stay in same section
-    QRegularExpression maxRegex1(
-        QString(
-            R"~~(<input[^>]*name="%1"[^>]*/?>(?:(?!<input)[\s\S]){0,300}\.val\((\d+)\))~~")
-            .arg(inputName));
-    QRegularExpressionMatch maxMatch = maxRegex1.match(response);
-
-    if (maxMatch.hasMatch()) {
-      maxCount = maxMatch.captured(1).toInt();
-      qDebug() << "[TROOP] Found max count via val() after input:" << maxCount;
-    }
-
-    if (maxCount <= 0) {
-      // Pattern 2: Find name="t1" input, then the next <a>NUMBER</a> within 300
-      // chars
-      QRegularExpression maxRegex2(
-          QString(
-              R"~~(<input[^>]*name="%1"[^>]*/?>(?:(?!<input)[\s\S]){0,300}<a[^>]*>(\d+)</a>)~~")
-              .arg(inputName));
-      QRegularExpressionMatch maxMatch2 = maxRegex2.match(response);
-      if (maxMatch2.hasMatch()) {
-        maxCount = maxMatch2.captured(1).toInt();
-        qDebug() << "[TROOP] Found max count via link text after input:"
-                 << maxCount;
-      }
+bool TravianDataFetcher::parseStockBar(
+    const QString &page, int stock[ResourceSnapshot::ResourceCount]) {
+  for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+    QRegularExpression stockRegex(
+        QString(R"~~(id="l%1"[^>]*>&#x202d;([\d.]+)&#x202c;)~~").arg(r + 1));
+    QRegularExpressionMatch stockMatch = stockRegex.match(page);
+    if (!stockMatch.hasMatch()) {
+      return false;
     }
+    stock[r] = stockMatch.captured(1).remove('.').toInt();
+  }
+  return true;
+}
 
-    if (maxCount <= 0) {
-      qDebug() << "[TROOP] No troops available to train for" << troopName
-               << "at village" << villageId << "- resources insufficient or building busy";
-      // Don't emit error - this is expected when resources are low
-      // Timer will try again on next interval
-      return;
-    }
+bool TravianDataFetcher::absorbActionResponse(int villageId,
+                                              const QString &pageName,
+                                              const QString &html,
+                                              qint64 timeBaseMs) {
+  QJsonObject pages = m_config["pages"].toObject();
+  if (villageId <= 0 || !pages.contains(pageName)) {
+    return false;
+  }
 
-    // Find the form action URL (method may be before or after action)
-    QRegularExpression formRegex(R"~~(<form[^>]*action="([^"]+)"[^>]*>)~~");
-    QRegularExpressionMatch formMatch = formRegex.match(response);
+  // Hata ya da giriş sayfası köy durumunu bozmasın: kaynak çubuğu ve
+  // sayfanın ana listesi olmalı
+  int stock[ResourceSnapshot::ResourceCount] = {};
+  if (!parseStockBar(html, stock)) {
+    return false;
+  }
+  QVariantMap pageData =
+      HtmlParser::parsePageData(html, pages[pageName].toObject());
+  if ((pageName == "dorf1" && pageData["resourceFields"].toList().isEmpty()) ||
+      (pageName == "dorf2" && pageData["buildings"].toList().isEmpty())) {
+    return false;
+  }
 
-    QString formAction;
-    if (formMatch.hasMatch()) {
-      formAction = formMatch.captured(1).replace("&amp;", "&");
-      if (formAction.startsWith("/")) {
-        formAction = m_baseUrl + formAction;
-      }
-      // CRITICAL: Add newdid to form action to ensure POST is processed in correct village
-      if (!formAction.contains("newdid=") && villageId > 0) {
-        formAction += (formAction.contains("?") ? "&" : "?");
-        formAction += "newdid=" + QString::number(villageId);
-      }
-      qDebug() << "[TROOP] Form action (with newdid):" << formAction;
-    } else {
-      // Fallback: use build.php with newdid
-      formAction = m_baseUrl + "/build.php?id=" + QString::number(slotId);
-      if (villageId > 0) {
-        formAction += "&newdid=" + QString::number(villageId);
-      }
-      qDebug() << "[TROOP] Using fallback form action:" << formAction;
-    }
-
-    // Collect hidden inputs
-    QRegularExpression hiddenRegex(
-        R"~~(<input[^>]*type="hidden"[^>]*name="([^"]+)"[^>]*value="([^"]*)")~~");
-    QRegularExpressionMatchIterator hiddenIt =
-        hiddenRegex.globalMatch(response);
-
-    QUrlQuery postData;
-    while (hiddenIt.hasNext()) {
-      QRegularExpressionMatch m = hiddenIt.next();
-      postData.addQueryItem(m.captured(1), m.captured(2));
-      qDebug() << "[TROOP] Hidden input:" << m.captured(1) << "="
-               << m.captured(2);
-    }
-
-    // Also try reversed attribute order: value before name
-    QRegularExpression hiddenRegex2(
-        R"~~(<input[^>]*type="hidden"[^>]*value="([^"]*)"[^>]*name="([^"]+)")~~");
-    QRegularExpressionMatchIterator hiddenIt2 =
-        hiddenRegex2.globalMatch(response);
-    while (hiddenIt2.hasNext()) {
-      QRegularExpressionMatch m = hiddenIt2.next();
-      QString name = m.captured(2);
-      QString value = m.captured(1);
-      if (!postData.hasQueryItem(name)) {
-        postData.addQueryItem(name, value);
-        qDebug() << "[TROOP] Hidden input (rev):" << name << "=" << value;
+  QString villageName = m_villageStore.villageName(villageId);
+  qint64 savedTimeBase = m_pageTimeBaseMs;
+  m_pageTimeBaseMs = timeBaseMs;
+  storeVillageData(villageId, villageName, pageName, pageData);
+  m_pageTimeBaseMs = savedTimeBase;
+
+  // dorf1 dışındaki sayfalarda harcama sonrası stok sadece kaynak çubuğunda:
+  // dorf1'e taşı. fetchedAt inşaat sürelerinin tabanı olduğu için
+  // değişmez; stok o ana geri projekte edilir
+  if (pageName != "dorf1") {
+    ResourceSnapshot snapshot = m_villageStore.resources(villageId);
+    if (snapshot.isValid()) {
+      double hours = (timeBaseMs - snapshot.fetchedAtMs()) / 3600000.0;
+      int rebased[ResourceSnapshot::ResourceCount];
+      for (int r = 0; r < ResourceSnapshot::ResourceCount; ++r) {
+        auto res = static_cast<ResourceSnapshot::Resource>(r);
+        // Eski zaman tabanında düşük stok eksiye inebilir; depo sınırında kırp
+        int projected = qRound(stock[r] - snapshot.production(res) * hours);
+        rebased[r] = qBound(0, projected, snapshot.capacity(res));
       }
+      // İçerik değişti: zaman tabanı aynı kalır, generation ilerler
+      m_villageStore.setStock(villageId, rebased, ++m_pageGeneration);
     }
-
-    // Set the troop count - HTML input name is "t1", "t2", etc. (same as
-    // inputName)
-    postData.addQueryItem(inputName, QString::number(maxCount));
-
-    // Add submit button value (s1=ok) as required by the form
-    postData.addQueryItem("s1", "ok");
-
-    qDebug() << "[TROOP] Training" << maxCount << "of" << troopName << "("
-             << troopId << "=" << maxCount << ")";
-    qDebug() << "[TROOP] POST data:" << postData.toString(QUrl::FullyEncoded);
-
-    // Submit the form via POST
-    QNetworkRequest postRequest;
-    postRequest.setUrl(QUrl(formAction));
-    postRequest.setRawHeader("User-Agent", m_sessionUserAgent.toUtf8());
-    postRequest.setRawHeader("Content-Type",
-                             "application/x-www-form-urlencoded");
-    postRequest.setRawHeader(
-        "Referer",
-        (m_baseUrl + "/build.php?id=" + QString::number(slotId)).toUtf8());
-
-    QNetworkReply *postReply = m_networkManager->post(
-        postRequest, postData.toString(QUrl::FullyEncoded).toUtf8());
-    postReply->setProperty("isTrainRequest", true);
-    postReply->setProperty("trainStep", "doTrain");
-    postReply->setProperty("villageId", villageId);
-    postReply->setProperty("slotId", slotId);
-    postReply->setProperty("troopId", troopId);
-    postReply->setProperty("troopName", troopName);
-    postReply->setProperty("trainCount", maxCount);
-
-    connect(postReply, &QNetworkReply::finished, this,
-            [this, postReply]() { onTrainTroopFinished(postReply); });
-    return;
   }
 
-  if (trainStep == "doTrain") {
-    QString troopName = reply->property("troopName").toString();
-    int trainCount = reply->property("trainCount").toInt();
-
+  qDebug() << "[ACTION] Village" << villageId << pageName
+           << "updated from action response";
+  return true;
+}
+
+QString TravianDataFetcher::militaryPageName(int villageId, int slotId) const {
+  const QVariantList buildings =
+      m_villageStore.page(villageId, "dorf2")["buildings"].toList();
+  for (const QVariant &building : buildings) {
+    QVariantMap b = building.toMap();
+    if (b["slotId"].toInt() != slotId) {
+      continue;
+    }
+    switch (b["gid"].toInt()) {
+    case 19:
+      return "barracks";
+    case 20:
+      return "stable";
+    case 21:
+      return "workshop";
+    default:
+      return QString();
+    }
+  }
+  return QString();
+}
+
+void TravianDataFetcher::storeTrainingForm(int villageId, int slotId,
+                                           const QString &page) {
+  // Sadece eğitim formu olan sayfalar saklanır
+  if (!page.contains("name=\"checksum\"") || !page.contains("name=\"snd\"")) {
+    return;
+  }
+
+  TrainingFormCacheEntry entry;
+  entry.html = page;
+  entry.storedAtMs = QDateTime::currentMSecsSinceEpoch();
+  m_trainingForms[QString("%1_%2").arg(villageId).arg(slotId)] = entry;
+}
+
+void TravianDataFetcher::postTrainingForm(int villageId, int slotId,
+                                          const QString &troopId,
+                                          const QString &configuredName,
+                                          int trainSeconds, const QString &page,
+                                          bool fromCache, int pageAgeSeconds) {
+  // Extract troop number from troopId (e.g., "t1" -> "1", "t3" -> "3")
+  // Also handle global IDs (e.g. "u11" -> "t1", "u21" -> "t1")
+  QString inputName = troopId;
+  if (troopId.startsWith("u")) {
+    int gid = troopId.mid(1).toInt();
+    int rid = (gid - 1) % 10 + 1;
+    inputName = "t" + QString::number(rid);
+    qDebug() << "[TROOP] Converted global ID" << troopId
+             << "to relative input" << inputName;
+  } else if (troopId.startsWith("t")) {
+    // Already relative or old format
+    inputName = troopId;
+  }
+
+  // Use troop name from config, fallback to troopId
+  QString troopName = configuredName;
+  if (troopName.isEmpty()) {
+    troopName = troopId;
+  }
+  qDebug() << "[TROOP] Using troop name:" << troopName;
+
+  // Find the max trainable count for this troop
+  // HTML structure inside <div class="cta">:
+  //   <input name="t1" value="0" />
+  //   <span> / </span>
+  //   <a href="#" onclick="...val(11)...">11</a>
+  // The input and max link are very close together, within ~200 chars
+  int maxCount = 0;
+
+  // Pattern 1: Find name="t1" input, then the very next .val(N) within same
+  // cta block Use [\s\S] instead of . to match across newlines, with negative
+  // lookahead to stay in same section
+  QRegularExpression maxRegex1(
+      QString(
+          R"~~(<input[^>]*name="%1"[^>]*/?>(?:(?!<input)[\s\S]){0,300}\.val\((\d+)\))~~")
+          .arg(inputName));
+  QRegularExpressionMatch maxMatch = maxRegex1.match(page);
+
+  if (maxMatch.hasMatch()) {
+    maxCount = maxMatch.captured(1).toInt();
+    qDebug() << "[TROOP] Found max count via val() after input:" << maxCount;
+  }
+
+  if (maxCount <= 0) {
+    // Pattern 2: Find name="t1" input, then the next <a>NUMBER</a> within 300
+    // chars
+    QRegularExpression maxRegex2(
+        QString(
+            R"~~(<input[^>]*name="%1"[^>]*/?>(?:(?!<input)[\s\S]){0,300}<a[^>]*>(\d+)</a>)~~")
+            .arg(inputName));
+    QRegularExpressionMatch maxMatch2 = maxRegex2.match(page);
+    if (maxMatch2.hasMatch()) {
+      maxCount = maxMatch2.captured(1).toInt();
+      qDebug() << "[TROOP] Found max count via link text after input:"
+               << maxCount;
+    }
+  }
+
+  // Önbellekteki sayfanın max bağlantısı eskidir: sayfadaki stok ve köyün
+  // üretiminden yeniden hesapla
+  if (fromCache) {
+    const int *unitCost =
+        troopId.startsWith("u") ? UnitData::cost(troopId.mid(1).toInt())
+                                : nullptr;
+    ResourceSnapshot snapshot =
+        trainingPageSnapshot(villageId, page, pageAgeSeconds);
+    if (!unitCost || !snapshot.isValid()) {
+      // Tahmin yapılamıyor: sayfayı çekerek devam et
+      m_trainingForms.remove(QString("%1_%2").arg(villageId).arg(slotId));
+      trainTroops(villageId, slotId, troopId, configuredName, trainSeconds);
+      return;
+    }
+    maxCount = snapshot.affordableCount(unitCost,
+                                        QDateTime::currentMSecsSinceEpoch());
+    qDebug() << "[TROOP] Cached form - projected max count:" << maxCount;
+  }
+
+  if (maxCount <= 0) {
+    qDebug() << "[TROOP] No troops available to train for" << troopName
+             << "at village" << villageId << "- resources insufficient or building busy";
+    // Don't emit error - this is expected when resources are low
+    // Timer will try again on next interval
+    return;
+  }
+
+  // Önbellekteki sayfadan bu yana kuyruk ilerledi
+  int queueSeconds = qMax(0, trainingQueueEnd(page) - pageAgeSeconds);
+  int unitSeconds = unitTrainingSeconds(page, inputName);
+
+  // Hedef süre verildiyse kuyruğu yalnızca o kadar doldur
+  int trainCount = maxCount;
+  if (trainSeconds > 0 && unitSeconds > 0) {
+    trainCount = qBound(1, (trainSeconds + unitSeconds - 1) / unitSeconds,
+                        maxCount);
+  }
+  qDebug() << "[TROOP] Queue:" << queueSeconds << "s, per unit:"
+           << unitSeconds << "s, training" << trainCount << "of max"
+           << maxCount;
+
+  // Find the form action URL (method may be before or after action)
+  QRegularExpression formRegex(R"~~(<form[^>]*action="([^"]+)"[^>]*>)~~");
+  QRegularExpressionMatch formMatch = formRegex.match(page);
+
+  QString formAction;
+  if (formMatch.hasMatch()) {
+    formAction = formMatch.captured(1).replace("&amp;", "&");
+    if (formAction.startsWith("/")) {
+      formAction = m_baseUrl + formAction;
+    }
+    // CRITICAL: Add newdid to form action to ensure POST is processed in correct village
+    if (!formAction.contains("newdid=") && villageId > 0) {
+      formAction += (formAction.contains("?") ? "&" : "?");
+      formAction += "newdid=" + QString::number(villageId);
+    }
+    qDebug() << "[TROOP] Form action (with newdid):" << formAction;
+  } else {
+    // Fallback: use build.php with newdid
+    formAction = m_baseUrl + "/build.php?id=" + QString::number(slotId);
+    if (villageId > 0) {
+      formAction += "&newdid=" + QString::number(villageId);
+    }
+    qDebug() << "[TROOP] Using fallback form action:" << formAction;
+  }
+
+  // Collect hidden inputs
+  QRegularExpression hiddenRegex(
+      R"~~(<input[^>]*type="hidden"[^>]*name="([^"]+)"[^>]*value="([^"]*)")~~");
+  QRegularExpressionMatchIterator hiddenIt = hiddenRegex.globalMatch(page);
+
+  QUrlQuery postData;
+  while (hiddenIt.hasNext()) {
+    QRegularExpressionMatch m = hiddenIt.next();
+    postData.addQueryItem(m.captured(1), m.captured(2));
+    qDebug() << "[TROOP] Hidden input:" << m.captured(1) << "="
+             << m.captured(2);
+  }
+
+  // Also try reversed attribute order: value before name
+  QRegularExpression hiddenRegex2(
+      R"~~(<input[^>]*type="hidden"[^>]*value="([^"]*)"[^>]*name="([^"]+)")~~");
+  QRegularExpressionMatchIterator hiddenIt2 = hiddenRegex2.globalMatch(page);
+  while (hiddenIt2.hasNext()) {
+    QRegularExpressionMatch m = hiddenIt2.next();
+    QString name = m.captured(2);
+    QString value = m.captured(1);
+    if (!postData.hasQueryItem(name)) {
+      postData.addQueryItem(name, value);
+      qDebug() << "[TROOP] Hidden input (rev):" << name << "=" << value;
+    }
+  }
+
+  // Set the troop count - HTML input name is "t1", "t2", etc. (same as
+  // inputName)
+  postData.addQueryItem(inputName, QString::number(trainCount));
+
+  // Add submit button value (s1=ok) as required by the form
+  postData.addQueryItem("s1", "ok");
+
+  qDebug() << "[TROOP] Training" << trainCount << "of" << troopName << "("
+           << troopId << "=" << trainCount << ")";
+  qDebug() << "[TROOP] POST data:" << postData.toString(QUrl::FullyEncoded);
+
+  // Submit the form via POST
+  QNetworkRequest postRequest;
+  postRequest.setUrl(QUrl(formAction));
+  postRequest.setRawHeader("User-Agent", m_sessionUserAgent.toUtf8());
+  postRequest.setRawHeader("Content-Type",
+                           "application/x-www-form-urlencoded");
+  postRequest.setRawHeader(
+      "Referer",
+      (m_baseUrl + "/build.php?id=" + QString::number(slotId)).toUtf8());
+
+  QNetworkReply *postReply = m_networkManager->post(
+      postRequest, postData.toString(QUrl::FullyEncoded).toUtf8());
+  postReply->setProperty("isTrainRequest", true);
+  postReply->setProperty("trainStep", "doTrain");
+  postReply->setProperty("sentAtMs", QDateTime::currentMSecsSinceEpoch());
+  postReply->setProperty("villageId", villageId);
+  postReply->setProperty("slotId", slotId);
+  postReply->setProperty("troopId", troopId);
+  postReply->setProperty("troopName", troopName);
+  postReply->setProperty("trainCount", trainCount);
+  postReply->setProperty("queueSeconds", queueSeconds);
+  postReply->setProperty("unitSeconds", unitSeconds);
+  postReply->setProperty("trainSeconds", trainSeconds);
+  postReply->setProperty("fromCache", fromCache);
+
+  connect(postReply, &QNetworkReply::finished, this,
+          [this, postReply]() { onTrainTroopFinished(postReply); });
+}
+
+void TravianDataFetcher::onTrainTroopFinished(QNetworkReply *reply) {
+  QString trainStep = reply->property("trainStep").toString();
+  int villageId = reply->property("villageId").toInt();
+  int slotId = reply->property("slotId").toInt();
+  QString troopId = reply->property("troopId").toString();
+
+  if (reply->error() != QNetworkReply::NoError) {
+    QString error = reply->errorString();
+    qWarning() << "[TROOP] Network error:" << error;
+    emit troopTrainingResult(villageId, false, troopId, 0,
+                             "Ağ hatası: " + error);
+    reply->deleteLater();
+    return;
+  }
+
+  QByteArray rawData = reply->readAll();
+  rawData = decompressGzip(rawData);
+  QString response = QString::fromUtf8(rawData);
+
+  qint64 timeBaseMs = observeServerTime(reply, response);
+  refreshCookiesFromResponse(reply);
+  reply->deleteLater();
+
+  if (trainStep == "getPage") {
+    qDebug() << "[TROOP] Got building page, parsing for troop:" << troopId;
+
+    // Save debug HTML
+    QFile debugFile("/Users/kekinci/Desktop/test/config/debug_train_page.html");
+    if (debugFile.open(QIODevice::WriteOnly)) {
+      debugFile.write(response.toUtf8());
+      debugFile.close();
+    }
+
+    storeTrainingForm(villageId, slotId, response);
+    postTrainingForm(villageId, slotId, troopId,
+                     reply->property("troopName").toString(),
+                     reply->property("trainSeconds").toInt(), response, false,
+                     0);
+    return;
+  }
+
+  if (trainStep == "doTrain") {
+    QString troopName = reply->property("troopName").toString();
+    int trainCount = reply->property("trainCount").toInt();
+    int queueSeconds = reply->property("queueSeconds").toInt();
+    int unitSeconds = reply->property("unitSeconds").toInt();
+
     qDebug() << "[TROOP] Training POST response received for" << troopName
              << "at village" << villageId;
 
@@ -1324,28 +1924,66 @@ void TravianDataFetcher::onTrainTroopFinished(QNetworkReply *reply) {
       responseFile.close();
     }
 
+    // Önbellekteki form reddedildiyse (eski checksum) kuyruk uzamaz: formu
+    // at ve sayfayı çekerek bir kez daha dene
+    int responseQueue = trainingQueueEnd(response);
+    int expectedGrowth = unitSeconds > 0 ? trainCount * unitSeconds / 2 : 1;
+    QString formKey = QString("%1_%2").arg(villageId).arg(slotId);
+    if (reply->property("fromCache").toBool() &&
+        responseQueue < queueSeconds + expectedGrowth) {
+      qWarning() << "[TROOP] Cached training form rejected at village"
+                 << villageId << "- refetching building page";
+      m_trainingForms.remove(formKey);
+      trainTroops(villageId, slotId, troopId, troopName,
+                  reply->property("trainSeconds").toInt());
+      return;
+    }
+
+    // Yanıt sayfası formun güncel halini taşır - sonraki eğitim için sakla
+    storeTrainingForm(villageId, slotId, response);
+
+    // Yanıttaki kuyruk sonu tahminden daha doğrudur
+    int queueEnd = responseQueue > 0 ? responseQueue
+                                     : queueSeconds + trainCount * unitSeconds;
+
     // Check for success indicators
     if (response.contains("buildingList") ||
         response.contains("under_progress") || response.contains("timer") ||
         response.contains("dur_r")) {
       qInfo() << "[TROOP] Training started:" << trainCount << "x" << troopName
               << "at village" << villageId;
+      if (queueEnd > 0) {
+        emit trainingQueueUpdated(villageId, troopId, queueEnd);
+      }
       emit troopTrainingResult(
           villageId, true, troopName, trainCount,
           QString("%1x %2 eğitim başlatıldı").arg(trainCount).arg(troopName));
+      // Yanıt binanın tam sayfası: kuyruk ve kaynaklar yenilemesiz güncellenir
+      if (absorbActionResponse(villageId, militaryPageName(villageId, slotId),
+                               response, timeBaseMs)) {
+        emit villageRefreshed(villageId, getVillageData(villageId));
+      }
     } else if (response.contains("notEnough") ||
                response.contains("enough resources")) {
       qWarning() << "[TROOP] Not enough resources for" << troopName
                  << "at village" << villageId;
+      m_trainingForms.remove(formKey);
       emit troopTrainingResult(villageId, false, troopName, 0,
                                "Yeterli kaynak yok");
     } else {
       // Usually successful - Travian redirects after training
       qInfo() << "[TROOP] Training likely started:" << trainCount << "x"
               << troopName << "at village" << villageId;
+      if (queueEnd > 0) {
+        emit trainingQueueUpdated(villageId, troopId, queueEnd);
+      }
       emit troopTrainingResult(
           villageId, true, troopName, trainCount,
           QString("%1x %2 eğitim başlatıldı").arg(trainCount).arg(troopName));
+      if (absorbActionResponse(villageId, militaryPageName(villageId, slotId),
+                               response, timeBaseMs)) {
+        emit villageRefreshed(villageId, getVillageData(villageId));
+      }
     }
   }
 }
@@ -1358,6 +1996,11 @@ void TravianDataFetcher::processNextRequest() {
   if (m_requestQueue.isEmpty()) {
     m_isProcessing = false;
 
+    // Sadece köy bazlı yenileme yapılıyorsa allDataFetched yayınlanmaz
+    if (!m_fullCycleActive) {
+      return;
+    }
+
     // If there are more villages to process
     if (!m_villages.isEmpty() && m_currentVillageIndex < m_villages.size()) {
       VillageInfo &village = m_villages[m_currentVillageIndex];
@@ -1365,16 +2008,20 @@ void TravianDataFetcher::processNextRequest() {
       fetchVillageData(village.id, village.name);
       m_currentVillageIndex++;
 
-      m_totalRequests += m_requestQueue.size();
       processNextRequest();
       return;
     }
 
     // All done
     if (!m_villages.isEmpty()) {
+      qDebug() << "[PLANNER] Cycle done:" << m_refreshPlanner.requestedCount()
+               << "pages fetched," << m_refreshPlanner.skippedCount()
+               << "skipped (fresh)"
+               << (m_refreshPlanner.isFullSweep() ? "[full sweep]" : "");
     }
 
-    emit allDataFetched(m_collectedData);
+    m_fullCycleActive = false;
+    emit allDataFetched(getAllData());
     return;
   }
 
@@ -1386,7 +2033,8 @@ void TravianDataFetcher::processNextRequest() {
   PendingRequest req = m_requestQueue.dequeue();
   m_currentPageName = req.pageName;
 
-  int delay = getRandomDelay();
+  // Kullanıcının seçtiği köy: insan tıklaması gibi en kısa bekleme
+  int delay = req.isPriority ? m_delayMin : getRandomDelay();
   QString displayName = req.villageName.isEmpty()
                             ? req.pageName
                             : req.villageName + "/" + req.pageName;
@@ -1426,6 +2074,9 @@ void TravianDataFetcher::processNextRequest() {
     reply->setProperty("villageId", req.villageId);
     reply->setProperty("villageName", req.villageName);
     reply->setProperty("isVillageListRequest", req.isVillageListRequest);
+    reply->setProperty("isTargeted", req.isTargeted);
+    reply->setProperty("isPriority", req.isPriority);
+    reply->setProperty("sentAtMs", QDateTime::currentMSecsSinceEpoch());
   });
 }
 
@@ -1448,6 +2099,8 @@ void TravianDataFetcher::onRequestFinished(QNetworkReply *reply) {
 
   QString pageName = reply->property("pageName").toString();
   bool isVillageListRequest = reply->property("isVillageListRequest").toBool();
+  bool isTargeted = reply->property("isTargeted").toBool();
+  bool isPriority = reply->property("isPriority").toBool();
 
   // --- Fix 5: Network error retry with exponential backoff ---
   if (reply->error() != QNetworkReply::NoError) {
@@ -1470,7 +2123,8 @@ void TravianDataFetcher::onRequestFinished(QNetworkReply *reply) {
 
       QTimer::singleShot(delayMs, this,
                          [this, pageName, retryUrl, pageConfig, villageId,
-                          villageName, isVillageListRequest]() {
+                          villageName, isVillageListRequest, isTargeted,
+                          isPriority]() {
                            PendingRequest retryReq;
                            retryReq.pageName = pageName;
                            retryReq.pageConfig = pageConfig;
@@ -1478,6 +2132,8 @@ void TravianDataFetcher::onRequestFinished(QNetworkReply *reply) {
                            retryReq.villageName = villageName;
                            retryReq.isVillageListRequest =
                                isVillageListRequest;
+                           retryReq.isTargeted = isTargeted;
+                           retryReq.isPriority = isPriority;
                            retryReq.url = retryUrl.toString();
                            m_requestQueue.prepend(retryReq);
                            processNextRequest();
@@ -1492,6 +2148,9 @@ void TravianDataFetcher::onRequestFinished(QNetworkReply *reply) {
       resetNetworkManager();
     }
     emit fetchError(pageName, reply->errorString());
+    if (isTargeted) {
+      finishTargetedRequest(reply->property("villageId").toInt());
+    }
     reply->deleteLater();
     processNextRequest();
     return;
@@ -1508,6 +2167,9 @@ void TravianDataFetcher::onRequestFinished(QNetworkReply *reply) {
   rawData = decompressGzip(rawData);
   QString html = QString::fromUtf8(rawData);
 
+  // Sayfadaki süreler bu andan sayar; storeVillageData "fetchedAt" yapar
+  m_pageTimeBaseMs = observeServerTime(reply, html);
+
   // Extract request info before deleting reply
   QJsonObject pageConfig = reply->property("pageConfig").toJsonObject();
   int villageId = reply->property("villageId").toInt();
@@ -1520,25 +2182,58 @@ void TravianDataFetcher::onRequestFinished(QNetworkReply *reply) {
 
   if (isVillageListRequest) {
     handleVillageListResponse(html);
+  } else if (pageName.startsWith("_overview")) {
+    handleOverviewResponse(html, pageName);
   } else {
     PendingRequest req;
     req.pageName = pageName;
     req.pageConfig = pageConfig;
     req.villageId = villageId;
     req.villageName = villageName;
+    req.isPriority = isPriority;
+    req.isTargeted = isTargeted;
     handlePageResponse(html, req);
+
+    if (isTargeted) {
+      finishTargetedRequest(villageId);
+    }
   }
+  m_pageTimeBaseMs = 0;
 
   processNextRequest();
 }
 
-void TravianDataFetcher::handleVillageListResponse(const QString &html) {
-  // ✅ village list response'u kaydet
-  // HTML logging disabled
+qint64 TravianDataFetcher::observeServerTime(QNetworkReply *reply,
+                                             const QString &html) {
+  qint64 receivedAt = QDateTime::currentMSecsSinceEpoch();
+  bool ok = false;
+  qint64 sentAt = reply->property("sentAtMs").toLongLong(&ok);
+  if (!ok || sentAt <= 0) {
+    return receivedAt;
+  }
+
+  // Sayfa sayacı sayfanın üretildiği saniyedir; yoksa Date başlığı
+  qint64 serverSeconds = ServerClock::serverSecondsFromPage(html);
+  if (serverSeconds < 0) {
+    serverSeconds =
+        ServerClock::serverSecondsFromDateHeader(reply->rawHeader("Date"));
+  }
+  m_serverClock.addSample(sentAt, receivedAt, serverSeconds);
+  return m_serverClock.pageTimeBaseMs(sentAt, receivedAt, serverSeconds);
+}
 
+bool TravianDataFetcher::updateVillageList(const QString &html) {
   m_villages = VillageParser::parseVillageList(html);
 
+  // Önceki döngülerden kalan veri VillageStore'da durur; listeden çıkan
+  // köyleri unut
+  QSet<int> activeIds;
   for (const VillageInfo &v : m_villages) {
+    activeIds.insert(v.id);
+  }
+  const QList<int> removed = m_villageStore.retain(activeIds);
+  for (int id : removed) {
+    m_refreshPlanner.forgetVillage(id);
   }
 
   emit villagesDiscovered(m_villages);
@@ -1546,6 +2241,24 @@ void TravianDataFetcher::handleVillageListResponse(const QString &html) {
   if (m_villages.isEmpty()) {
     emit fetchError("_villageList",
                     "Session expired - no villages found (401)");
+    return false;
+  }
+
+  // Saldırı bilgisi tüm köyler için bu sayfada mevcut
+  QVariantList villageListWithAttacks =
+      HtmlParser::extractVillageListWithAttacks(html);
+  if (!villageListWithAttacks.isEmpty()) {
+    m_accountData["villageListWithAttacks"] = villageListWithAttacks;
+  }
+
+  return true;
+}
+
+void TravianDataFetcher::handleVillageListResponse(const QString &html) {
+  // ✅ village list response'u kaydet
+  // HTML logging disabled
+
+  if (!updateVillageList(html)) {
     return;
   }
 
@@ -1556,15 +2269,18 @@ void TravianDataFetcher::handleVillageListResponse(const QString &html) {
     QJsonObject page = pages["dorf1"].toObject();
     QVariantMap pageData = HtmlParser::parsePageData(html, page);
     storeVillageData(m_villages[0].id, m_villages[0].name, "dorf1", pageData);
+    m_refreshPlanner.noteRequested();
   }
 
-  // Queue dorf2.php request for first village
-  if (pages.contains("dorf2")) {
+  // Queue dorf2.php request for first village (only if it is stale)
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if (pages.contains("dorf2") &&
+      m_refreshPlanner.isDue(m_villages[0].id, RefreshPlanner::Dorf2, now)) {
     QJsonObject page = pages["dorf2"].toObject();
 
     PendingRequest req;
     req.pageName = "dorf2";
-    req.url = m_baseUrl + "/dorf2.php";
+    req.url = buildVillageUrl("/dorf2.php", m_villages[0].id);
     req.pageConfig = page;
     req.villageId = m_villages[0].id;
     req.villageName = m_villages[0].name;
@@ -1572,11 +2288,90 @@ void TravianDataFetcher::handleVillageListResponse(const QString &html) {
 
     m_requestQueue.enqueue(req);
     m_totalRequests++;
+    m_refreshPlanner.noteRequested();
+  } else {
+    m_refreshPlanner.noteSkipped();
+    enqueueMilitaryBuildingRequests(m_villages[0].id, m_villages[0].name,
+                                    m_villageStore.page(m_villages[0].id, "dorf2"));
+    reportIncomingAttacks(m_villages[0].id);
   }
 
   m_currentVillageIndex = 1; // First village already processed
 }
 
+void TravianDataFetcher::handleOverviewResponse(const QString &html,
+                                                const QString &pageName) {
+  if (pageName == "_overviewTroops") {
+    const QMap<int, QVariantMap> troops = OverviewParser::parseTroops(html);
+    for (const VillageInfo &village : m_villages) {
+      auto it = troops.constFind(village.id);
+      if (it != troops.constEnd()) {
+        storeVillageData(village.id, village.name, "troopOverview", *it);
+      }
+    }
+    qDebug() << "[OVERVIEW] Troop overview parsed for" << troops.size()
+             << "villages";
+    return;
+  }
+
+  if (pageName == "_overviewResources") {
+    m_overviewRows = OverviewParser::parseResources(html);
+    if (m_overviewRows.isEmpty()) {
+      qDebug() << "[OVERVIEW] Resources tab not available - falling back to "
+                  "per-village dorf1";
+    }
+    return;
+  }
+
+  // Son istek: köy listesi her sayfada gömülü, inşaatlar genel bakış
+  // sekmesinde
+  if (!updateVillageList(html)) {
+    m_overviewRows.clear();
+    return;
+  }
+
+  const QMap<int, QVariantMap> construction =
+      OverviewParser::parseConstruction(html);
+  int merged = 0;
+
+  for (const VillageInfo &village : m_villages) {
+    auto resources = m_overviewRows.constFind(village.id);
+    auto buildings = construction.constFind(village.id);
+
+    // Kaynak ya da inşaat süresi eksikse bu köyün dorf1'i normal yoldan
+    // (planlayıcıya göre) çekilir
+    if (resources == m_overviewRows.constEnd() ||
+        buildings == construction.constEnd() ||
+        !buildings->value("complete").toBool()) {
+      continue;
+    }
+
+    // Alan seviyeleri, üretim ve depo kapasitesi için en az bir tam dorf1
+    // gerekli
+    QVariantMap dorf1 = m_villageStore.page(village.id, "dorf1");
+    if (dorf1.isEmpty()) {
+      continue;
+    }
+
+    for (auto it = resources->constBegin(); it != resources->constEnd();
+         ++it) {
+      dorf1[it.key()] = it.value();
+    }
+    dorf1["constructionQueue"] = buildings->value("constructionQueue");
+
+    storeVillageData(village.id, village.name, "dorf1", dorf1);
+    emit villageDataUpdated(village.id, village.name,
+                            getVillageData(village.id));
+    merged++;
+  }
+
+  qDebug() << "[OVERVIEW]" << merged << "/" << m_villages.size()
+           << "villages updated from account overview";
+
+  m_overviewRows.clear();
+  m_currentVillageIndex = 0;
+}
+
 void TravianDataFetcher::handlePageResponse(const QString &html,
                                             const PendingRequest &req) {
   QString displayName = req.villageName.isEmpty()
@@ -1596,7 +2391,7 @@ void TravianDataFetcher::handlePageResponse(const QString &html,
   if (req.pageName == "dorf1" || req.pageName == "dorf2") {
     QVariantList villageListWithAttacks = HtmlParser::extractVillageListWithAttacks(html);
     if (!villageListWithAttacks.isEmpty()) {
-      m_collectedData["villageListWithAttacks"] = villageListWithAttacks;
+      m_accountData["villageListWithAttacks"] = villageListWithAttacks;
     }
   }
 
@@ -1604,95 +2399,102 @@ void TravianDataFetcher::handlePageResponse(const QString &html,
     storeVillageData(req.villageId, req.villageName, req.pageName, pageData);
     emit villageDataUpdated(
         req.villageId, req.villageName,
-        m_collectedData.value("village_" + QString::number(req.villageId))
-            .toMap());
+        m_villageStore.villageData(req.villageId));
 
     // buildings sayfasından sonra askeri binaları kontrol et ve onlar için de
     // request ekle
     if (req.pageName == "dorf2") {
-      enqueueMilitaryBuildingRequests(req.villageId, req.villageName, pageData);
+      // Köy bazlı yenilemede sadece istenen sayfalar çekilir
+      if (!req.isTargeted) {
+        enqueueMilitaryBuildingRequests(req.villageId, req.villageName,
+                                        pageData);
+      }
 
       // After dorf2 is saved, check for attacks and create attack summary from existing data
-      QVariantList villageListWithAttacks = m_collectedData["villageListWithAttacks"].toList();
-      for (const QVariant &villageVar : villageListWithAttacks) {
-        QVariantMap villageMap = villageVar.toMap();
-        if (villageMap["id"].toInt() == req.villageId) {
-          int attacksAmount = villageMap["incomingAttacksAmount"].toInt();
-          if (attacksAmount > 0) {
-            qDebug() << "[ATTACK] Village" << req.villageId << "has" << attacksAmount << "incoming attacks - creating attack summary from existing data";
-
-            // Create attack entries from the symbols data we already have
-            QVariantList attacks;
-            QVariantMap symbols = villageMap["incomingAttacksSymbols"].toMap();
-
-            int redCount = symbols["red"].toInt();
-            int yellowCount = symbols["yellow"].toInt();
-            int greenCount = symbols["green"].toInt();
-            int grayCount = symbols["gray"].toInt();
-
-            // Create placeholder attacks (we don't have exact timing from this data)
-            // But we can show the user that attacks are coming
-            for (int i = 0; i < redCount; i++) {
-              QVariantMap attack;
-              attack["type"] = "attack";
-              attack["symbol"] = "red";
-              attack["displayName"] = "Normal Saldırı";
-              attack["remainingSeconds"] = 0; // Unknown
-              attack["arrivalDateTime"] = "Bilinmiyor";
-              attacks.append(attack);
-            }
-            for (int i = 0; i < yellowCount; i++) {
-              QVariantMap attack;
-              attack["type"] = "raid";
-              attack["symbol"] = "yellow";
-              attack["displayName"] = "Yağma";
-              attack["remainingSeconds"] = 0;
-              attack["arrivalDateTime"] = "Bilinmiyor";
-              attacks.append(attack);
-            }
-            for (int i = 0; i < greenCount; i++) {
-              QVariantMap attack;
-              attack["type"] = "support";
-              attack["symbol"] = "green";
-              attack["displayName"] = "Destek";
-              attack["remainingSeconds"] = 0;
-              attack["arrivalDateTime"] = "Bilinmiyor";
-              attacks.append(attack);
-            }
-            for (int i = 0; i < grayCount; i++) {
-              QVariantMap attack;
-              attack["type"] = "other";
-              attack["symbol"] = "gray";
-              attack["displayName"] = "Diğer";
-              attack["remainingSeconds"] = 0;
-              attack["arrivalDateTime"] = "Bilinmiyor";
-              attacks.append(attack);
-            }
+      reportIncomingAttacks(req.villageId);
+    }
+  } else {
+    m_accountData[req.pageName] = pageData;
+    emit dataUpdated(req.pageName, pageData);
+  }
 
-            if (!attacks.isEmpty()) {
-              qDebug() << "[ATTACK] ✅ Emitting" << attacks.size() << "attacks for village" << req.villageId;
-              for (const QVariant &attack : attacks) {
-                qDebug() << "[ATTACK]   -" << attack.toMap()["displayName"].toString()
-                         << "(" << attack.toMap()["type"].toString() << ")";
-              }
-              emit incomingAttacksFetched(req.villageId, attacks);
-            } else {
-              qDebug() << "[ATTACK] ⚠️ No attacks created from symbols data (all counts were 0)";
-            }
+  logPageData(req.pageName, pageData);
+}
 
-            // Fetch detailed timing from rally point HTML
-            //             fetchIncomingAttacks(req.villageId);
+void TravianDataFetcher::reportIncomingAttacks(int villageId) {
+  QVariantList villageListWithAttacks = m_accountData["villageListWithAttacks"].toList();
+  for (const QVariant &villageVar : villageListWithAttacks) {
+    QVariantMap villageMap = villageVar.toMap();
+    if (villageMap["id"].toInt() == villageId) {
+      int attacksAmount = villageMap["incomingAttacksAmount"].toInt();
+      if (attacksAmount > 0) {
+        qDebug() << "[ATTACK] Village" << villageId << "has" << attacksAmount << "incoming attacks - creating attack summary from existing data";
+
+        // Create attack entries from the symbols data we already have
+        QVariantList attacks;
+        QVariantMap symbols = villageMap["incomingAttacksSymbols"].toMap();
+
+        int redCount = symbols["red"].toInt();
+        int yellowCount = symbols["yellow"].toInt();
+        int greenCount = symbols["green"].toInt();
+        int grayCount = symbols["gray"].toInt();
+
+        // Create placeholder attacks (we don't have exact timing from this data)
+        // But we can show the user that attacks are coming
+        for (int i = 0; i < redCount; i++) {
+          QVariantMap attack;
+          attack["type"] = "attack";
+          attack["symbol"] = "red";
+          attack["displayName"] = "Normal Saldırı";
+          attack["remainingSeconds"] = 0; // Unknown
+          attack["arrivalDateTime"] = "Bilinmiyor";
+          attacks.append(attack);
+        }
+        for (int i = 0; i < yellowCount; i++) {
+          QVariantMap attack;
+          attack["type"] = "raid";
+          attack["symbol"] = "yellow";
+          attack["displayName"] = "Yağma";
+          attack["remainingSeconds"] = 0;
+          attack["arrivalDateTime"] = "Bilinmiyor";
+          attacks.append(attack);
+        }
+        for (int i = 0; i < greenCount; i++) {
+          QVariantMap attack;
+          attack["type"] = "support";
+          attack["symbol"] = "green";
+          attack["displayName"] = "Destek";
+          attack["remainingSeconds"] = 0;
+          attack["arrivalDateTime"] = "Bilinmiyor";
+          attacks.append(attack);
+        }
+        for (int i = 0; i < grayCount; i++) {
+          QVariantMap attack;
+          attack["type"] = "other";
+          attack["symbol"] = "gray";
+          attack["displayName"] = "Diğer";
+          attack["remainingSeconds"] = 0;
+          attack["arrivalDateTime"] = "Bilinmiyor";
+          attacks.append(attack);
+        }
+
+        if (!attacks.isEmpty()) {
+          qDebug() << "[ATTACK] ✅ Emitting" << attacks.size() << "attacks for village" << villageId;
+          for (const QVariant &attack : attacks) {
+            qDebug() << "[ATTACK]   -" << attack.toMap()["displayName"].toString()
+                     << "(" << attack.toMap()["type"].toString() << ")";
           }
-          break;
+          emit incomingAttacksFetched(villageId, attacks);
+        } else {
+          qDebug() << "[ATTACK] ⚠️ No attacks created from symbols data (all counts were 0)";
         }
+
+        // Fetch detailed timing from rally point HTML
+        //             fetchIncomingAttacks(villageId);
       }
+      break;
     }
-  } else {
-    m_collectedData[req.pageName] = pageData;
-    emit dataUpdated(req.pageName, pageData);
   }
-
-  logPageData(req.pageName, pageData);
 }
 
 void TravianDataFetcher::enqueueMilitaryBuildingRequests(
@@ -1706,6 +2508,7 @@ void TravianDataFetcher::enqueueMilitaryBuildingRequests(
 
   QVariantList buildings = buildingsData["buildings"].toList();
   QJsonObject pages = m_config["pages"].toObject();
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
 
   for (const QVariant &building : buildings) {
     QVariantMap b = building.toMap();
@@ -1723,6 +2526,13 @@ void TravianDataFetcher::enqueueMilitaryBuildingRequests(
       continue;
     }
 
+    // Eğitilebilir birlik listesi nadiren değişir
+    if (!m_refreshPlanner.isDue(villageId,
+                                RefreshPlanner::pageFromName(pageName), now)) {
+      m_refreshPlanner.noteSkipped();
+      continue;
+    }
+
     QJsonObject page = pages[pageName].toObject();
 
     PendingRequest req;
@@ -1741,6 +2551,7 @@ void TravianDataFetcher::enqueueMilitaryBuildingRequests(
 
     m_requestQueue.enqueue(req);
     m_totalRequests++;
+    m_refreshPlanner.noteRequested();
   }
 }
 // ============================================================================
@@ -1751,9 +2562,7 @@ void TravianDataFetcher::fetchFarmLists(int villageId) {
   qDebug() << "[FARM] fetchFarmLists called for villageId:" << villageId;
 
   // Find rally point (gid=16) slot ID from village data
-  QString villageKey = "village_" + QString::number(villageId);
-  QVariantMap villageData = m_collectedData.value(villageKey).toMap();
-  QVariantMap dorf2 = villageData["dorf2"].toMap();
+  QVariantMap dorf2 = m_villageStore.page(villageId, "dorf2");
   QVariantList buildings = dorf2["buildings"].toList();
 
   int rallyPointSlotId = -1;
@@ -1798,22 +2607,56 @@ void TravianDataFetcher::fetchFarmLists(int villageId) {
 }
 
 void TravianDataFetcher::executeFarmList(int villageId, int listId) {
-  qDebug() << "[FARM] executeFarmList called - village:" << villageId
-           << "listId:" << listId;
+  executeFarmLists(villageId, {listId});
+}
+
+void TravianDataFetcher::executeFarmLists(int villageId,
+                                          const QList<int> &listIds) {
+  qDebug() << "[FARM] executeFarmLists called - village:" << villageId
+           << "lists:" << listIds;
+
+  if (listIds.isEmpty()) {
+    return;
+  }
 
   // Initialize retry info if needed
-  QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
-  if (!m_farmRetries.contains(retryKey)) {
-    FarmRetryInfo info;
-    info.villageId = villageId;
-    info.listId = listId;
-    info.retryCount = 0;
-    m_farmRetries[retryKey] = info;
+  for (int listId : listIds) {
+    QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
+    if (!m_farmRetries.contains(retryKey)) {
+      FarmRetryInfo info;
+      info.villageId = villageId;
+      info.listId = listId;
+      info.retryCount = 0;
+      m_farmRetries[retryKey] = info;
+    }
+  }
+
+  // Tüm listelerin önbellekte taze slotları varsa sayfayı çekmeden gönder
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  QMap<int, QJsonArray> listSlots;
+  for (int listId : listIds) {
+    auto cached = m_farmListCache.constFind(listId);
+    if (cached == m_farmListCache.constEnd() ||
+        cached->villageId != villageId || cached->activeSlotIds.isEmpty() ||
+        now - cached->confirmedAtMs >= FARM_CACHE_TTL_MS ||
+        now - cached->fetchedAtMs >= FARM_RESYNC_INTERVAL_MS) {
+      break;
+    }
+    listSlots[listId] = cached->activeSlotIds;
+  }
+
+  if (listSlots.size() == listIds.size()) {
+    qDebug() << "[FARM] Using cached slots for" << listSlots.size()
+             << "list(s)";
+    sendFarmListsPost(villageId, listSlots);
+    return;
   }
 
-  // Step 1: Fetch farm list page to get active slot IDs
-  QString fetchUrl =
-      m_baseUrl + "/build.php?id=39&tt=99&newdid=" + QString::number(villageId);
+  // Step 1: Fetch farm list page to get active slot IDs (sayfa köyün tüm
+  // listelerini içerir, tek istek yeterli)
+  QString fetchUrl = m_baseUrl + "/build.php?id=" +
+                     QString::number(rallyPointSlot(villageId)) +
+                     "&tt=99&newdid=" + QString::number(villageId);
 
   QNetworkRequest request;
   request.setUrl(QUrl(fetchUrl));
@@ -1824,7 +2667,7 @@ void TravianDataFetcher::executeFarmList(int villageId, int listId) {
   reply->setProperty("isFarmListRequest", true);
   reply->setProperty("farmStep", "executeFetchSlots");
   reply->setProperty("villageId", villageId);
-  reply->setProperty("listId", listId);
+  reply->setProperty("listIds", QVariant::fromValue(listIds));
 
   connect(reply, &QNetworkReply::finished, this,
           [this, reply]() { onFarmListFinished(reply); });
@@ -1832,15 +2675,39 @@ void TravianDataFetcher::executeFarmList(int villageId, int listId) {
 
 void TravianDataFetcher::sendFarmListPost(int villageId, int listId,
                                           const QJsonArray &slotIds) {
-  // Step 2: POST to /api/v1/farm-list/send with slot IDs
-  QString apiUrl = m_baseUrl + "/api/v1/farm-list/send";
+  QMap<int, QJsonArray> listSlots;
+  listSlots[listId] = slotIds;
+  sendFarmListsPost(villageId, listSlots);
+}
 
-  QJsonObject listObj;
-  listObj["id"] = listId;
-  listObj["targets"] = slotIds;
+void TravianDataFetcher::sendFarmListsPost(
+    int villageId, const QMap<int, QJsonArray> &listSlots) {
+  // Step 2: POST to /api/v1/farm-list/send with slot IDs (birden fazla liste
+  // aynı istekte gönderilebilir)
+  QString apiUrl = m_baseUrl + "/api/v1/farm-list/send";
 
+  // Verimsiz hedefler yağma geçmişine göre ayıklanır
   QJsonArray listsArray;
-  listsArray.append(listObj);
+  QList<int> sentListIds;
+  for (auto it = listSlots.constBegin(); it != listSlots.constEnd(); ++it) {
+    QJsonArray targets = m_raidYield.selectTargets(it.value());
+    if (targets.isEmpty()) {
+      qDebug() << "[FARM] List" << it.key() << "has no productive targets";
+      emit farmListExecuted(villageId, it.key(), false,
+                            "Verimli hedef yok (tüm slotlar ayıklandı)");
+      continue;
+    }
+
+    QJsonObject listObj;
+    listObj["id"] = it.key();
+    listObj["targets"] = targets;
+    listsArray.append(listObj);
+    sentListIds.append(it.key());
+  }
+
+  if (listsArray.isEmpty()) {
+    return;
+  }
 
   QJsonObject requestBody;
   requestBody["action"] = QString("farmList");
@@ -1859,8 +2726,9 @@ void TravianDataFetcher::sendFarmListPost(int villageId, int listId,
   apiRequest.setRawHeader("Accept-Encoding", "identity");
   apiRequest.setRawHeader("X-Requested-With", "XMLHttpRequest");
   apiRequest.setRawHeader(
-      "Referer", (m_baseUrl +
-                  "/build.php?id=39&tt=99&newdid=" + QString::number(villageId))
+      "Referer", (m_baseUrl + "/build.php?id=" +
+                  QString::number(rallyPointSlot(villageId)) +
+                  "&tt=99&newdid=" + QString::number(villageId))
                      .toUtf8());
   apiRequest.setRawHeader("Origin", m_baseUrl.toUtf8());
 
@@ -1868,12 +2736,364 @@ void TravianDataFetcher::sendFarmListPost(int villageId, int listId,
   reply->setProperty("isFarmListRequest", true);
   reply->setProperty("farmStep", "executePost");
   reply->setProperty("villageId", villageId);
-  reply->setProperty("listId", listId);
+  reply->setProperty("listIds", QVariant::fromValue(sentListIds));
 
   connect(reply, &QNetworkReply::finished, this,
           [this, reply]() { onFarmListFinished(reply); });
 }
 
+void TravianDataFetcher::retryFarmLists(int villageId,
+                                        const QList<int> &listIds,
+                                        int delayMs,
+                                        const QString &failMessage) {
+  QList<int> retryIds;
+
+  for (int listId : listIds) {
+    QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
+    FarmRetryInfo &retryInfo = m_farmRetries[retryKey];
+    retryInfo.villageId = villageId;
+    retryInfo.listId = listId;
+
+    if (retryInfo.retryCount < MAX_FARM_RETRIES) {
+      retryInfo.retryCount++;
+      qWarning() << "[FARM] List" << listId << "- retry"
+                 << retryInfo.retryCount << "/" << MAX_FARM_RETRIES << "in"
+                 << delayMs << "ms";
+      retryIds.append(listId);
+    } else {
+      qWarning() << "[FARM] List" << listId << "failed after"
+                 << MAX_FARM_RETRIES << "retries - giving up";
+      // Reset retry count for next execution
+      retryInfo.retryCount = 0;
+      emit farmListExecuted(villageId, listId, false, failMessage);
+    }
+  }
+
+  if (!retryIds.isEmpty()) {
+    QTimer::singleShot(delayMs, this, [this, villageId, retryIds]() {
+      executeFarmLists(villageId, retryIds);
+    });
+  }
+}
+
+QJsonArray TravianDataFetcher::parseActiveFarmSlots(const QString &response,
+                                                   int listId) const {
+  // Find slotsStates for the target farm list
+  // Format in viewData:
+  // "id":1691,...,"slotsStates":[{"id":56722,"isActive":true},...] We need to
+  // find the slotsStates array for our specific list ID
+  // Use regex for whitespace-tolerant matching: "id": 1691 or "id":1691
+  QRegularExpression farmListsStartRegex(R"~~("farmLists"\s*:\s*\[)~~");
+  QRegularExpressionMatch flStartMatch = farmListsStartRegex.match(response);
+  int searchStartPos = flStartMatch.hasMatch() ? flStartMatch.capturedStart() : 0;
+
+  QRegularExpression listIdRegex(
+      QString(R"~~("id"\s*:\s*%1\b)~~").arg(listId));
+  QRegularExpressionMatch listIdMatch = listIdRegex.match(response, searchStartPos);
+  int listPos = listIdMatch.hasMatch() ? listIdMatch.capturedStart() : -1;
+
+  qDebug() << "[FARM] List ID pattern found at position:" << listPos
+           << "(searchStart:" << searchStartPos << ")";
+
+  QJsonArray activeSlotIds;
+
+  if (listPos >= 0) {
+    // Find slotsStates after this list's position
+    QString slotsStatesKey = "\"slotsStates\"";
+    int slotsPos = response.indexOf(slotsStatesKey, listPos);
+
+    qDebug() << "[FARM] slotsStates found at position:" << slotsPos;
+
+    // Make sure we didn't overshoot to the next list
+    int nextListPos = response.indexOf("\"farmLists\"", listPos + 10);
+    if (nextListPos < 0)
+      nextListPos = response.length();
+
+    qDebug() << "[FARM] Next list position:" << nextListPos
+             << "slotsPos valid:" << (slotsPos >= 0 && slotsPos < nextListPos);
+
+    if (slotsPos >= 0 && slotsPos < nextListPos) {
+      // Find the array start
+      int arrayStart = response.indexOf('[', slotsPos);
+      if (arrayStart >= 0) {
+        // Find matching bracket end
+        int depth = 0;
+        int arrayEnd = arrayStart;
+        for (int i = arrayStart; i < response.length(); i++) {
+          QChar c = response[i];
+          if (c == '[')
+            depth++;
+          else if (c == ']') {
+            depth--;
+            if (depth == 0) {
+              arrayEnd = i + 1;
+              break;
+            }
+          }
+        }
+
+        QString slotsJson = response.mid(arrayStart, arrayEnd - arrayStart);
+        qDebug() << "[FARM] Extracted slotsStates JSON (first 200 chars):"
+                 << slotsJson.left(200);
+
+        QJsonDocument slotsDoc = QJsonDocument::fromJson(slotsJson.toUtf8());
+        QJsonArray slotsArray = slotsDoc.array();
+
+        qDebug() << "[FARM] Parsed slots array - total slots:" << slotsArray.size();
+
+        for (const QJsonValue &slot : slotsArray) {
+          QJsonObject slotObj = slot.toObject();
+          int slotId = slotObj["id"].toInt();
+          bool isActive = slotObj["isActive"].toBool();
+          qDebug() << "[FARM] Slot" << slotId << "isActive:" << isActive;
+
+          if (isActive) {
+            activeSlotIds.append(slotId);
+          }
+        }
+      } else {
+        qWarning() << "[FARM] Could not find array start after slotsStates";
+      }
+    } else {
+      qWarning() << "[FARM] slotsStates not found or out of range";
+    }
+  } else {
+    qWarning() << "[FARM] List ID" << listId << "not found in response";
+  }
+
+  return activeSlotIds;
+}
+
+void TravianDataFetcher::storeFarmListSlots(int villageId, int listId,
+                                            const QJsonArray &activeSlotIds) {
+  FarmListCacheEntry entry;
+  entry.villageId = villageId;
+  entry.activeSlotIds = activeSlotIds;
+  entry.fetchedAtMs = QDateTime::currentMSecsSinceEpoch();
+  entry.confirmedAtMs = entry.fetchedAtMs;
+  m_farmListCache[listId] = entry;
+}
+
+QVariantList TravianDataFetcher::applyFarmSendResult(int listId,
+                                                     const QJsonObject &listObj) {
+  QVariantList slotResults;
+  QSet<int> failedSlots;
+
+  // "targets": [{"id": 151042, "error": null}, ...]
+  const QJsonArray targets = listObj["targets"].toArray();
+  for (const QJsonValue &target : targets) {
+    QJsonObject targetObj = target.toObject();
+    int slotId = targetObj["id"].toInt();
+    QJsonValue error = targetObj["error"];
+
+    QVariantMap slotResult;
+    slotResult["slotId"] = slotId;
+    slotResult["success"] = error.isNull() || error.isUndefined();
+    if (!slotResult["success"].toBool()) {
+      slotResult["error"] = error.isObject()
+                                ? error.toObject()["message"].toString()
+                                : error.toVariant().toString();
+      failedSlots.insert(slotId);
+    }
+    slotResults.append(slotResult);
+  }
+
+  // Önbellek yanıtla tazelenir: hata veren slotlar bir sonraki tam
+  // senkronizasyona kadar çıkarılır, diğerleri (ayıklanıp gönderilmeyenler
+  // dahil) aktif kalır
+  auto cached = m_farmListCache.find(listId);
+  if (cached != m_farmListCache.end()) {
+    if (!failedSlots.isEmpty()) {
+      QJsonArray activeSlotIds;
+      for (const QJsonValue &slotId : cached->activeSlotIds) {
+        if (!failedSlots.contains(slotId.toInt())) {
+          activeSlotIds.append(slotId);
+        }
+      }
+      cached->activeSlotIds = activeSlotIds;
+    }
+    cached->confirmedAtMs = QDateTime::currentMSecsSinceEpoch();
+  }
+
+  return slotResults;
+}
+
+QJsonObject TravianDataFetcher::parseFarmListObject(const QString &response,
+                                                    int listId) const {
+  QRegularExpression farmListsStartRegex(R"~~("farmLists"\s*:\s*\[)~~");
+  QRegularExpressionMatch flStartMatch = farmListsStartRegex.match(response);
+  if (!flStartMatch.hasMatch()) {
+    return QJsonObject();
+  }
+
+  QRegularExpression listIdRegex(
+      QString(R"~~("id"\s*:\s*%1\b)~~").arg(listId));
+  QRegularExpressionMatch listIdMatch =
+      listIdRegex.match(response, flStartMatch.capturedEnd());
+  if (!listIdMatch.hasMatch()) {
+    return QJsonObject();
+  }
+
+  // Listenin nesnesi id'den önceki ilk '{' ile başlar
+  int objectStart = response.lastIndexOf('{', listIdMatch.capturedStart());
+  if (objectStart < flStartMatch.capturedEnd()) {
+    return QJsonObject();
+  }
+
+  // Find matching brace end
+  int depth = 0;
+  int objectEnd = -1;
+  for (int i = objectStart; i < response.length(); i++) {
+    QChar c = response[i];
+    if (c == '{')
+      depth++;
+    else if (c == '}') {
+      depth--;
+      if (depth == 0) {
+        objectEnd = i + 1;
+        break;
+      }
+    }
+  }
+  if (objectEnd < 0) {
+    return QJsonObject();
+  }
+
+  QJsonDocument doc = QJsonDocument::fromJson(
+      response.mid(objectStart, objectEnd - objectStart).toUtf8());
+  return doc.object();
+}
+
+int TravianDataFetcher::farmListRoundTripSeconds(
+    int villageId, const QJsonObject &listObj) const {
+  int tribe = m_villageStore.page(villageId, "dorf1")["tribe"].toInt();
+  int longest = -1;
+
+  const QJsonArray slots = listObj["slots"].toArray();
+  for (const QJsonValue &slotVal : slots) {
+    QJsonObject slot = slotVal.toObject();
+    if (slot.contains("isActive") && !slot["isActive"].toBool()) {
+      continue;
+    }
+
+    double distance = slot["distance"].toDouble();
+    if (distance <= 0) {
+      continue;
+    }
+
+    // Grup en yavaş birliğin hızında yürür ("troop": {"t1": 5, "t4": 2})
+    int slowest = 0;
+    const QJsonObject troop = slot["troop"].toObject();
+    for (auto it = troop.constBegin(); it != troop.constEnd(); ++it) {
+      if (it.value().toInt() <= 0) {
+        continue;
+      }
+      int unitSpeed =
+          UnitData::speed(UnitData::globalId(tribe, it.key().mid(1).toInt()));
+      if (unitSpeed > 0 && (slowest == 0 || unitSpeed < slowest)) {
+        slowest = unitSpeed;
+      }
+    }
+    if (slowest == 0) {
+      continue;
+    }
+
+    int roundTrip =
+        static_cast<int>(2.0 * distance / (slowest * m_troopSpeed) * 3600.0);
+    longest = qMax(longest, roundTrip);
+  }
+
+  return longest;
+}
+
+void TravianDataFetcher::recordRaidYield(int listId,
+                                         const QJsonObject &listObj) {
+  const QJsonArray slots = listObj["slots"].toArray();
+  if (slots.isEmpty()) {
+    return;
+  }
+
+  QSet<int> slotIds;
+  bool changed = false;
+
+  for (const QJsonValue &slotVal : slots) {
+    QJsonObject slot = slotVal.toObject();
+    int slotId = slot["id"].toInt();
+    slotIds.insert(slotId);
+
+    // "lastRaid": {"time": ..., "reportType"/"icon": "iReport2",
+    //              "raidedResources": {...}, "bootyMax": ...}
+    QJsonObject lastRaid = slot["lastRaid"].toObject();
+    if (lastRaid.isEmpty()) {
+      continue;
+    }
+
+    QString reportType = lastRaid.contains("reportType")
+                             ? lastRaid["reportType"].toVariant().toString()
+                             : lastRaid["icon"].toString();
+    static const QRegularExpression digitRegex("(\\d+)");
+    int resultCode = digitRegex.match(reportType).captured(1).toInt();
+    RaidYieldStore::RaidResult result =
+        resultCode >= RaidYieldStore::Won && resultCode <= RaidYieldStore::Lost
+            ? static_cast<RaidYieldStore::RaidResult>(resultCode)
+            : RaidYieldStore::Unknown;
+
+    // Rapor ganimet içermiyorsa bilinmiyor (-1); boş yağma sayılmaz
+    int loot = -1;
+    QJsonValue raided = lastRaid["raidedResources"];
+    if (raided.isObject()) {
+      loot = 0;
+      const QJsonObject resources = raided.toObject();
+      for (auto it = resources.constBegin(); it != resources.constEnd(); ++it) {
+        loot += it.value().toInt();
+      }
+    } else if (raided.isDouble()) {
+      loot = raided.toInt();
+    }
+
+    changed |= m_raidYield.recordRaid(
+        listId, slotId, lastRaid["time"].toVariant().toLongLong(), result,
+        loot, lastRaid["bootyMax"].toInt());
+  }
+
+  m_raidYield.retainSlots(listId, slotIds);
+  if (changed) {
+    m_raidYield.save();
+  }
+}
+
+void TravianDataFetcher::updateFarmListStats(int villageId, int listId,
+                                             const QString &response) {
+  QJsonObject listObj = parseFarmListObject(response, listId);
+  if (listObj.isEmpty()) {
+    return;
+  }
+
+  recordRaidYield(listId, listObj);
+
+  int roundTrip = farmListRoundTripSeconds(villageId, listObj);
+  if (roundTrip <= 0) {
+    return;
+  }
+
+  qDebug() << "[FARM] List" << listId << "round trip:" << roundTrip << "s";
+  emit farmListTimingUpdated(villageId, listId, roundTrip);
+}
+
+void TravianDataFetcher::invalidateFarmListCache(int listId) {
+  if (listId < 0) {
+    m_farmListCache.clear();
+  } else {
+    m_farmListCache.remove(listId);
+  }
+}
+
+int TravianDataFetcher::rallyPointSlot(int villageId) const {
+  // Mitingin (gid=16) yeri neredeyse her zaman 39, yine de dorf2'den bak
+  int slotId = findBuildingSlot(villageId, 16);
+  return slotId > 0 ? slotId : 39;
+}
+
 void TravianDataFetcher::onFarmListFinished(QNetworkReply *reply) {
   QString farmStep = reply->property("farmStep").toString();
   int villageId = reply->property("villageId").toInt();
@@ -1891,34 +3111,25 @@ void TravianDataFetcher::onFarmListFinished(QNetworkReply *reply) {
 
     // Retry logic for HTTP errors (400, 500, etc.)
     if (farmStep == "executePost" || farmStep == "executeFetchSlots") {
-      int listId = reply->property("listId").toInt();
-      QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
-      FarmRetryInfo &retryInfo = m_farmRetries[retryKey];
+      const QList<int> listIds =
+          reply->property("listIds").value<QList<int>>();
+      QString failMessage = QString("HTTP %1: %2 (%3 deneme)")
+                                .arg(statusCode)
+                                .arg(QString::fromUtf8(errorBody).left(100))
+                                .arg(MAX_FARM_RETRIES);
 
-      // Retry on 400, 500, or network errors
-      if ((statusCode >= 400 || statusCode == 0) && retryInfo.retryCount < MAX_FARM_RETRIES) {
-        retryInfo.retryCount++;
-        qWarning() << "[FARM] HTTP error" << statusCode << "for list" << listId
-                   << "- retry" << retryInfo.retryCount << "/" << MAX_FARM_RETRIES
-                   << "in" << FARM_RETRY_DELAY_MS << "ms";
-
-        reply->deleteLater();
-        QTimer::singleShot(FARM_RETRY_DELAY_MS, this, [this, villageId, listId]() {
-          executeFarmList(villageId, listId);
-        });
-        return;
+      // Önbellekteki slotlar hatalı olabilir - tekrar denemede sayfadan oku
+      for (int listId : listIds) {
+        invalidateFarmListCache(listId);
       }
 
-      // Max retries reached - report error
-      if (farmStep == "executePost") {
-        qWarning() << "[FARM] HTTP error" << statusCode << "for list" << listId
-                   << "after" << MAX_FARM_RETRIES << "retries - giving up";
-        emit farmListExecuted(villageId, listId, false,
-                            QString("HTTP %1: %2 (%3 deneme)")
-                                .arg(statusCode)
-                                .arg(QString::fromUtf8(errorBody).left(100))
-                                .arg(MAX_FARM_RETRIES));
-        retryInfo.retryCount = 0;
+      // Retry on 400, 500, or network errors
+      if (statusCode >= 400 || statusCode == 0) {
+        retryFarmLists(villageId, listIds, FARM_RETRY_DELAY_MS, failMessage);
+      } else {
+        for (int listId : listIds) {
+          emit farmListExecuted(villageId, listId, false, failMessage);
+        }
       }
     }
     reply->deleteLater();
@@ -1926,7 +3137,7 @@ void TravianDataFetcher::onFarmListFinished(QNetworkReply *reply) {
   }
 
   // Extract all reply properties BEFORE deleteLater (Bonus fix)
-  int listId = reply->property("listId").toInt();
+  const QList<int> listIds = reply->property("listIds").value<QList<int>>();
   int httpStatusCode =
       reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
@@ -1958,28 +3169,10 @@ void TravianDataFetcher::onFarmListFinished(QNetworkReply *reply) {
 
     // Retry with session refresh for farm execution
     if (farmStep == "executeFetchSlots") {
-      QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
-      FarmRetryInfo &retryInfo = m_farmRetries[retryKey];
-
-      if (retryInfo.retryCount < MAX_FARM_RETRIES) {
-        retryInfo.retryCount++;
-        int retryDelay = FARM_RETRY_DELAY_MS * 2; // 4 seconds for session issues
-        qWarning() << "[FARM] Session expired for list" << listId
-                   << "- retry" << retryInfo.retryCount << "/" << MAX_FARM_RETRIES
-                   << "in" << retryDelay << "ms (longer delay for session issue)";
-
-        QTimer::singleShot(retryDelay, this, [this, villageId, listId]() {
-          executeFarmList(villageId, listId);
-        });
-        return;
-      } else {
-        qCritical() << "[FARM] Session expired for list" << listId
-                    << "after" << MAX_FARM_RETRIES << "retries - CRITICAL: Cookies may need refresh!";
-        emit farmListExecuted(villageId, listId, false,
-                            "Oturum süresi doldu - cookie güncellemesi gerekli");
-        retryInfo.retryCount = 0;
-        return;
-      }
+      // 4 seconds for session issues
+      retryFarmLists(villageId, listIds, FARM_RETRY_DELAY_MS * 2,
+                     "Oturum süresi doldu - cookie güncellemesi gerekli");
+      return;
     }
 
     // For fetchLists, just report error
@@ -2060,6 +3253,14 @@ void TravianDataFetcher::onFarmListFinished(QNetworkReply *reply) {
           listInfo["ownerVillageId"] = ownerMatch.captured(1).toInt();
         }
 
+        // Sayfada tüm listelerin slot durumları var - sonraki gönderimler
+        // için önbelleğe al
+        QJsonArray activeSlotIds = parseActiveFarmSlots(response, listId);
+        if (!activeSlotIds.isEmpty()) {
+          storeFarmListSlots(villageId, listId, activeSlotIds);
+        }
+        updateFarmListStats(villageId, listId, response);
+
         lists.append(listInfo);
         qDebug() << "[FARM] Found farm list:" << listInfo;
       }
@@ -2072,141 +3273,52 @@ void TravianDataFetcher::onFarmListFinished(QNetworkReply *reply) {
   }
 
   else if (farmStep == "executeFetchSlots") {
-    // Step 1 response: Parse farm list page to get slot IDs for target list
-    // listId already extracted before deleteLater
-
-    qDebug() << "[FARM] Parsing farm list page for slot IDs - listId:" << listId
-             << "response length:" << response.length();
-
-    // Find slotsStates for the target farm list
-    // Format in viewData:
-    // "id":1691,...,"slotsStates":[{"id":56722,"isActive":true},...] We need to
-    // find the slotsStates array for our specific list ID
-    // Use regex for whitespace-tolerant matching: "id": 1691 or "id":1691
-    QRegularExpression farmListsStartRegex(R"~~("farmLists"\s*:\s*\[)~~");
-    QRegularExpressionMatch flStartMatch = farmListsStartRegex.match(response);
-    int searchStartPos = flStartMatch.hasMatch() ? flStartMatch.capturedStart() : 0;
-
-    QRegularExpression listIdRegex(
-        QString(R"~~("id"\s*:\s*%1\b)~~").arg(listId));
-    QRegularExpressionMatch listIdMatch = listIdRegex.match(response, searchStartPos);
-    int listPos = listIdMatch.hasMatch() ? listIdMatch.capturedStart() : -1;
-
-    qDebug() << "[FARM] List ID pattern found at position:" << listPos
-             << "(searchStart:" << searchStartPos << ")";
-
-    QJsonArray activeSlotIds;
-
-    if (listPos >= 0) {
-      // Find slotsStates after this list's position
-      QString slotsStatesKey = "\"slotsStates\"";
-      int slotsPos = response.indexOf(slotsStatesKey, listPos);
-
-      qDebug() << "[FARM] slotsStates found at position:" << slotsPos;
-
-      // Make sure we didn't overshoot to the next list
-      int nextListPos = response.indexOf("\"farmLists\"", listPos + 10);
-      if (nextListPos < 0)
-        nextListPos = response.length();
-
-      qDebug() << "[FARM] Next list position:" << nextListPos
-               << "slotsPos valid:" << (slotsPos >= 0 && slotsPos < nextListPos);
-
-      if (slotsPos >= 0 && slotsPos < nextListPos) {
-        // Find the array start
-        int arrayStart = response.indexOf('[', slotsPos);
-        if (arrayStart >= 0) {
-          // Find matching bracket end
-          int depth = 0;
-          int arrayEnd = arrayStart;
-          for (int i = arrayStart; i < response.length(); i++) {
-            QChar c = response[i];
-            if (c == '[')
-              depth++;
-            else if (c == ']') {
-              depth--;
-              if (depth == 0) {
-                arrayEnd = i + 1;
-                break;
-              }
-            }
-          }
-
-          QString slotsJson = response.mid(arrayStart, arrayEnd - arrayStart);
-          qDebug() << "[FARM] Extracted slotsStates JSON (first 200 chars):"
-                   << slotsJson.left(200);
+    // Step 1 response: Parse farm list page to get slot IDs for target lists
+    qDebug() << "[FARM] Parsing farm list page for slot IDs - lists:"
+             << listIds << "response length:" << response.length();
 
-          QJsonDocument slotsDoc = QJsonDocument::fromJson(slotsJson.toUtf8());
-          QJsonArray slotsArray = slotsDoc.array();
+    QMap<int, QJsonArray> listSlots;
+    QList<int> emptyLists;
 
-          qDebug() << "[FARM] Parsed slots array - total slots:" << slotsArray.size();
+    for (int listId : listIds) {
+      QJsonArray activeSlotIds = parseActiveFarmSlots(response, listId);
+      qDebug() << "[FARM] Found" << activeSlotIds.size()
+               << "active slots for list" << listId;
 
-          for (const QJsonValue &slot : slotsArray) {
-            QJsonObject slotObj = slot.toObject();
-            int slotId = slotObj["id"].toInt();
-            bool isActive = slotObj["isActive"].toBool();
-            qDebug() << "[FARM] Slot" << slotId << "isActive:" << isActive;
-
-            if (isActive) {
-              activeSlotIds.append(slotId);
-            }
-          }
-        } else {
-          qWarning() << "[FARM] Could not find array start after slotsStates";
-        }
-      } else {
-        qWarning() << "[FARM] slotsStates not found or out of range";
+      if (activeSlotIds.isEmpty()) {
+        emptyLists.append(listId);
+        continue;
       }
-    } else {
-      qWarning() << "[FARM] List ID" << listId << "not found in response";
-    }
 
-    qDebug() << "[FARM] Found" << activeSlotIds.size()
-             << "active slots for list" << listId;
+      storeFarmListSlots(villageId, listId, activeSlotIds);
+      updateFarmListStats(villageId, listId, response);
+      listSlots[listId] = activeSlotIds;
 
-    if (activeSlotIds.isEmpty()) {
-      // Retry logic for empty slots
+      // Success - reset retry count
       QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
-      FarmRetryInfo &retryInfo = m_farmRetries[retryKey];
-
-      if (retryInfo.retryCount < MAX_FARM_RETRIES) {
-        retryInfo.retryCount++;
-        qWarning() << "[FARM] No active slots found for list" << listId
-                   << "- retry" << retryInfo.retryCount << "/" << MAX_FARM_RETRIES
-                   << "in" << FARM_RETRY_DELAY_MS << "ms";
-
-        QTimer::singleShot(FARM_RETRY_DELAY_MS, this, [this, villageId, listId]() {
-          executeFarmList(villageId, listId);
-        });
-        return;
-      } else {
-        // Max retries reached
-        qWarning() << "[FARM] No active slots found for list" << listId
-                   << "after" << MAX_FARM_RETRIES << "retries - giving up";
-        emit farmListExecuted(villageId, listId, false,
-                            "Aktif slot bulunamadı (" + QString::number(MAX_FARM_RETRIES) + " deneme)");
-
-        // Reset retry count for next execution
-        retryInfo.retryCount = 0;
-        return;
+      if (m_farmRetries.contains(retryKey)) {
+        m_farmRetries[retryKey].retryCount = 0;
       }
     }
 
-    // Success - reset retry count
-    QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
-    if (m_farmRetries.contains(retryKey)) {
-      m_farmRetries[retryKey].retryCount = 0;
+    // Retry logic for empty slots
+    if (!emptyLists.isEmpty()) {
+      retryFarmLists(villageId, emptyLists, FARM_RETRY_DELAY_MS,
+                     "Aktif slot bulunamadı (" +
+                         QString::number(MAX_FARM_RETRIES) + " deneme)");
     }
 
-    // Proceed to Step 2: Send the farm list
-    sendFarmListPost(villageId, listId, activeSlotIds);
+    // Proceed to Step 2: Send the farm lists
+    if (!listSlots.isEmpty()) {
+      sendFarmListsPost(villageId, listSlots);
+    }
   }
 
   else if (farmStep == "executePost") {
-    // listId and httpStatusCode already extracted before deleteLater
+    // listIds and httpStatusCode already extracted before deleteLater
     int statusCode = httpStatusCode;
 
-    qDebug() << "[FARM] Farm list execution response for list:" << listId
+    qDebug() << "[FARM] Farm list execution response for lists:" << listIds
              << "status:" << statusCode;
     qDebug() << "[FARM] Response:" << response.left(1000);
 
@@ -2215,9 +3327,11 @@ void TravianDataFetcher::onFarmListFinished(QNetworkReply *reply) {
     QJsonObject jsonObj = jsonDoc.object();
 
     // Reset retry count on any response (success or error)
-    QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
-    if (m_farmRetries.contains(retryKey)) {
-      m_farmRetries[retryKey].retryCount = 0;
+    for (int listId : listIds) {
+      QString retryKey = QString("%1_%2").arg(villageId).arg(listId);
+      if (m_farmRetries.contains(retryKey)) {
+        m_farmRetries[retryKey].retryCount = 0;
+      }
     }
 
     // Check for errors
@@ -2230,17 +3344,66 @@ void TravianDataFetcher::onFarmListFinished(QNetworkReply *reply) {
         errorMsg = jsonObj["errors"].toString();
       }
       qWarning() << "[FARM] Send error:" << errorMsg;
-      emit farmListExecuted(villageId, listId, false, "Hata: " + errorMsg);
+      for (int listId : listIds) {
+        invalidateFarmListCache(listId);
+        emit farmListExecuted(villageId, listId, false, "Hata: " + errorMsg);
+      }
     }
     // Check for success
     else if (statusCode == 200) {
-      qInfo() << "[FARM] Farm list" << listId << "started successfully!";
-      emit farmListExecuted(villageId, listId, true,
-                            "Yağma listesi başlatıldı");
+      // Yanıttaki liste sonuçlarını id'ye göre ayır
+      QHash<int, QJsonObject> listResults;
+      const QJsonArray sentLists = jsonObj["lists"].toArray();
+      for (const QJsonValue &listVal : sentLists) {
+        QJsonObject listObj = listVal.toObject();
+        listResults[listObj["id"].toInt()] = listObj;
+      }
+
+      for (int listId : listIds) {
+        // Yanıtta olmayan listenin akıbeti bilinmiyor; başarı sayma
+        auto resultIt = listResults.constFind(listId);
+        if (resultIt == listResults.constEnd()) {
+          qWarning() << "[FARM] Farm list" << listId
+                     << "missing from send response";
+          invalidateFarmListCache(listId);
+          emit farmListExecuted(villageId, listId, false,
+                                "Yanıtta liste sonucu yok");
+          continue;
+        }
+        QJsonObject listObj = resultIt.value();
+
+        if (listObj.contains("error") && !listObj["error"].isNull()) {
+          QJsonValue error = listObj["error"];
+          QString errorMsg =
+              error.isObject() ? error.toObject()["message"].toString()
+                               : error.toVariant().toString();
+          qWarning() << "[FARM] Farm list" << listId << "rejected:" << errorMsg;
+          invalidateFarmListCache(listId);
+          emit farmListExecuted(villageId, listId, false, "Hata: " + errorMsg);
+          continue;
+        }
+
+        QVariantList slotResults = applyFarmSendResult(listId, listObj);
+        int sentCount = 0;
+        for (const QVariant &slotResult : slotResults) {
+          if (slotResult.toMap()["success"].toBool()) {
+            sentCount++;
+          }
+        }
+
+        qInfo() << "[FARM] Farm list" << listId << "started successfully!"
+                << sentCount << "/" << slotResults.size() << "targets sent";
+
+        emit farmListExecuted(villageId, listId, true,
+                              "Yağma listesi başlatıldı", slotResults);
+      }
     } else {
-      emit farmListExecuted(villageId, listId, false,
-                            "HTTP " + QString::number(statusCode) + ": " +
-                                response.left(200));
+      for (int listId : listIds) {
+        invalidateFarmListCache(listId);
+        emit farmListExecuted(villageId, listId, false,
+                              "HTTP " + QString::number(statusCode) + ": " +
+                                  response.left(200));
+      }
     }
   }
 }
@@ -2253,9 +3416,7 @@ void TravianDataFetcher::fetchIncomingAttacks(int villageId) {
   qDebug() << "[ATTACK] fetchIncomingAttacks called for villageId:" << villageId;
 
   // Find rally point (gid=16) slot ID from village data
-  QString villageKey = "village_" + QString::number(villageId);
-  QVariantMap villageData = m_collectedData.value(villageKey).toMap();
-  QVariantMap dorf2 = villageData["dorf2"].toMap();
+  QVariantMap dorf2 = m_villageStore.page(villageId, "dorf2");
   QVariantList buildings = dorf2["buildings"].toList();
 
   int rallyPointSlotId = -1;
@@ -2300,6 +3461,7 @@ void TravianDataFetcher::fetchIncomingAttacks(int villageId) {
   QNetworkReply *reply = m_networkManager->get(request);
   reply->setProperty("isAttackRequest", true);
   reply->setProperty("villageId", villageId);
+  reply->setProperty("sentAtMs", QDateTime::currentMSecsSinceEpoch());
   reply->setProperty("rallyPointSlotId", rallyPointSlotId);
 
   connect(reply, &QNetworkReply::finished, this,
@@ -2323,6 +3485,9 @@ void TravianDataFetcher::onIncomingAttacksFinished(QNetworkReply *reply) {
   qDebug() << "[ATTACK] Response size:" << response.length() << "bytes";
   qDebug() << "[ATTACK] First 200 chars:" << response.left(200);
 
+  // Sayfadaki kalan süreler bu andan sayar
+  qint64 timeBaseMs = observeServerTime(reply, response);
+
   // Refresh cookies
   refreshCookiesFromResponse(reply);
   reply->deleteLater();
@@ -2386,12 +3551,15 @@ void TravianDataFetcher::onIncomingAttacksFinished(QNetworkReply *reply) {
 
       // Extract timing information
       if (mov.contains("arrivalTime")) {
-        qint64 arrivalTimestamp = mov["arrivalTime"].toLongLong();
-        QDateTime arrivalTime = QDateTime::fromSecsSinceEpoch(arrivalTimestamp);
+        // Varış sunucu saatiyle verilir; yerel saate çevir
+        qint64 arrivalAtMs =
+            m_serverClock.toLocalMs(mov["arrivalTime"].toLongLong() * 1000);
+        QDateTime arrivalTime = QDateTime::fromMSecsSinceEpoch(arrivalAtMs);
         attack["arrivalDateTime"] = arrivalTime.toString("yyyy-MM-dd HH:mm:ss");
+        attack["arrivalAtMs"] = arrivalAtMs;
 
-        qint64 now = QDateTime::currentSecsSinceEpoch();
-        qint64 remaining = arrivalTimestamp - now;
+        qint64 remaining =
+            (arrivalAtMs - QDateTime::currentMSecsSinceEpoch()) / 1000;
         attack["remainingSeconds"] = static_cast<int>(remaining > 0 ? remaining : 0);
 
         qDebug() << "[ATTACK]   -" << displayName << "arrives in" << remaining << "seconds at" << attack["arrivalDateTime"].toString();
@@ -2399,8 +3567,10 @@ void TravianDataFetcher::onIncomingAttacksFinished(QNetworkReply *reply) {
         int remaining = mov["remainingSeconds"].toInt();
         attack["remainingSeconds"] = remaining;
 
-        QDateTime arrivalTime = QDateTime::currentDateTime().addSecs(remaining);
+        qint64 arrivalAtMs = timeBaseMs + remaining * 1000LL;
+        QDateTime arrivalTime = QDateTime::fromMSecsSinceEpoch(arrivalAtMs);
         attack["arrivalDateTime"] = arrivalTime.toString("yyyy-MM-dd HH:mm:ss");
+        attack["arrivalAtMs"] = arrivalAtMs;
 
         qDebug() << "[ATTACK]   -" << displayName << "arrives in" << remaining << "seconds";
       }
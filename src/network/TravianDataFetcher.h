@@ -1,8 +1,14 @@
 #ifndef TRAVIANDATAFETCHER_H
 #define TRAVIANDATAFETCHER_H
 
+#include "src/models/ResourceSnapshot.h"
+#include "src/models/VillageStore.h"
+#include "src/network/RaidYieldStore.h"
+#include "src/network/RefreshPlanner.h"
+#include "src/network/ServerClock.h"
 #include "src/parsers/VillageParser.h"
 #include <QDateTime>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QNetworkAccessManager>
@@ -47,20 +53,59 @@ public:
   void fetchAllData();
   void fetchPage(const QString &pageName, int villageId = -1);
 
+  // Hızlı yenileme: tüm hesabın kaynak ve inşaat durumunu genel bakış
+  // (dorf3) sekmelerinden 2 istekle alır, köy sayfalarını sadece
+  // RefreshPlanner gerekli gördüğünde çeker. allDataFetched ile biter.
+  void fetchAccountOverview();
+
+  // Açıksa her döngüye birlik genel bakışı (dorf3 s=5) eklenir: tüm
+  // köylerin birlik sayıları ve eğitim kuyrukları tek istekte
+  void setTroopOverviewEnabled(bool enabled) {
+    m_troopOverviewEnabled = enabled;
+  }
+
+  // Tek köyün belirli sayfalarını yeniler (RefreshPlanner::Page maskesi).
+  // Diğer köylerin ve sayfaların verisi silinmez, gelen sayfalar üzerine
+  // yazılır. Tüm istekler bitince villageRefreshed yayınlanır.
+  // priority: kullanıcı bu köyü seçti; istekler arka plan kuyruğunun önüne
+  // geçer ve en kısa bekleme ile gönderilir. Hiçbir sayfa kuyruğa girmediyse
+  // ya da öne alınmadıysa (bilinmeyen köy, istenen sayfa yok) false
+  bool refreshVillage(int villageId, int pageMask, bool priority = false);
+
   // Actions
   void upgradeBuilding(int villageId, int slotId);
+  // İnşaat bitmeden hemen önce bina sayfasını çekip yükseltme linkini saklar;
+  // sonraki upgradeBuilding sayfayı yeniden açmadan doğrudan gönderir
+  void prefetchBuildPage(int villageId, int slotId);
   void fetchFarmLists(int villageId);
   void executeFarmList(int villageId, int listId);
+  // Aynı köyün listelerini tek farm-list/send isteğinde gönderir; sonuçlar
+  // liste başına farmListExecuted ile bildirilir
+  void executeFarmLists(int villageId, const QList<int> &listIds);
   void sendFarmListPost(int villageId, int listId,
                          const QJsonArray &slotIds);
+  void sendFarmListsPost(int villageId,
+                         const QMap<int, QJsonArray> &listSlots);
+  // listId < 0 tüm önbelleği temizler (liste düzenlendiğinde çağrılır)
+  void invalidateFarmListCache(int listId = -1);
+  // Sunucunun birlik hızı çarpanı (yağma dönüş süresi hesabı için)
+  void setTroopSpeed(double speed) { m_troopSpeed = speed > 0 ? speed : 1.0; }
+  void loadRaidYield(const QString &path) { m_raidYield.load(path); }
+  // Sunucu saati farkı tahmini (sayfa süreleri bununla mutlak zamana çevrilir)
+  const ServerClock &serverClock() const { return m_serverClock; }
+  // trainSeconds > 0: kuyruğa en fazla bu kadar sürelik birlik ekler
+  // (0 = karşılanabilen en fazla adet)
   void trainTroops(int villageId, int slotId, const QString &troopId,
-                   const QString &troopName = QString());
+                   const QString &troopName = QString(),
+                   int trainSeconds = 0);
   void fetchIncomingAttacks(int villageId);
 
-  // Data access
-  QVariantMap getAllData() const { return m_collectedData; }
-  QList<VillageInfo> getVillages() const { return m_villages; }
+  // Data access (QVariant görünümleri VillageStore'dan istek anında kurulur)
+  QVariantMap getAllData() const;
+  QList<VillageInfo> getVillages() const;
   QVariantMap getVillageData(int villageId) const;
+  // Yöneticilerin sık okumaları (stok, sayfa damgaları) için, kopyasız
+  const VillageStore &villageStore() const { return m_villageStore; }
 
 signals:
   void villagesDiscovered(const QList<VillageInfo> &villages);
@@ -68,19 +113,30 @@ signals:
                           const QVariantMap &data);
   void dataUpdated(const QString &pageName, const QVariantMap &data);
   void allDataFetched(const QVariantMap &allData);
+  void villageRefreshed(int villageId, const QVariantMap &villageData);
   void fetchError(const QString &pageName, const QString &error);
   void fetchProgress(int current, int total, const QString &pageName);
   void loginSuccess();
   void loginFailed(const QString &error);
   void sessionExpiredAutoLogin();
-  void upgradeStarted(int villageId, int slotId, const QString &buildingName);
+  // villageUpdated: yeni inşaat kuyruğu dorf1 yanıtından köy durumuna
+  // işlendi (villageRefreshed ardından gelir), takip yenilemesi gerekmez
+  void upgradeStarted(int villageId, int slotId, const QString &buildingName,
+                      bool villageUpdated);
   void upgradeFailed(int villageId, int slotId, const QString &error);
   void farmListsFetched(int villageId, const QVariantList &lists);
+  // slotResults: gönderim yanıtındaki hedef başına {slotId, success, error}
   void farmListExecuted(int villageId, int listId, bool success,
-                        const QString &message);
+                        const QString &message,
+                        const QVariantList &slotResults = QVariantList());
+  // En uzak aktif hedefe gidiş-dönüş süresi (slottaki en yavaş birlikle)
+  void farmListTimingUpdated(int villageId, int listId, int roundTripSeconds);
   void troopTrainingResult(int villageId, bool success,
                            const QString &troopName, int count,
                            const QString &message);
+  // Eğitim sonrası binanın kuyruğunun bitmesine kalan süre (sn)
+  void trainingQueueUpdated(int villageId, const QString &troopId,
+                            int queueSeconds);
   void incomingAttacksFetched(int villageId, const QVariantList &attacks);
   void sessionHealthCheckResult(bool isValid);
 
@@ -103,6 +159,8 @@ private:
     int villageId = -1;
     QString villageName;
     bool isVillageListRequest = false;
+    bool isTargeted = false; // refreshVillage() isteği
+    bool isPriority = false; // kullanıcı seçimi, kuyruğun önünde
   };
 
   // Helpers
@@ -113,17 +171,68 @@ private:
   void enqueueMilitaryBuildingRequests(int villageId,
                                        const QString &villageName,
                                        const QVariantMap &buildingsData);
+  bool updateVillageList(const QString &html);
   void handleVillageListResponse(const QString &html);
+  void handleOverviewResponse(const QString &html, const QString &pageName);
+  // Yeni döngü için kuyruğu boşaltır; öncelikli istekler kalır
+  void clearRequestQueue();
+  void enqueueTroopOverviewRequest();
   void handlePageResponse(const QString &html, const PendingRequest &req);
   void storeVillageData(int villageId, const QString &villageName,
                         const QString &pageName, const QVariantMap &data);
+  void reportIncomingAttacks(int villageId);
+  int findBuildingSlot(int villageId, int gid) const;
+  void finishTargetedRequest(int villageId);
+  int rallyPointSlot(int villageId) const;
+  QJsonArray parseActiveFarmSlots(const QString &response, int listId) const;
+  void storeFarmListSlots(int villageId, int listId,
+                          const QJsonArray &activeSlotIds);
+  QVariantList applyFarmSendResult(int listId, const QJsonObject &listObj);
+  void retryFarmLists(int villageId, const QList<int> &listIds, int delayMs,
+                      const QString &failMessage);
+  QJsonObject parseFarmListObject(const QString &response, int listId) const;
+  int farmListRoundTripSeconds(int villageId,
+                               const QJsonObject &listObj) const;
+  void recordRaidYield(int listId, const QJsonObject &listObj);
+  void updateFarmListStats(int villageId, int listId,
+                           const QString &response);
   void logPageData(const QString &pageName, const QVariantMap &data);
 
+  // Building upgrade helpers
+  void requestBuildPage(int villageId, int slotId, const QString &upgradeStep);
+  QString findUpgradeUrl(const QString &page, int villageId, int slotId,
+                         bool allowBusyBuilder) const;
+  void sendUpgradeRequest(int villageId, int slotId, const QString &upgradeUrl,
+                          const QString &buildingName);
+
+  // Troop training helpers
+  void postTrainingForm(int villageId, int slotId, const QString &troopId,
+                        const QString &configuredName, int trainSeconds,
+                        const QString &page, bool fromCache,
+                        int pageAgeSeconds);
+  void storeTrainingForm(int villageId, int slotId, const QString &page);
+  static int trainingQueueEnd(const QString &page);
+  static int unitTrainingSeconds(const QString &page,
+                                 const QString &inputName);
+  ResourceSnapshot trainingPageSnapshot(int villageId, const QString &page,
+                                        int pageAgeSeconds) const;
+  static bool parseStockBar(const QString &page,
+                            int stock[ResourceSnapshot::ResourceCount]);
+
+  // İşlem yanıtı (yükseltme/eğitim) zaten tam bir sayfa: normal sayfa
+  // ayrıştırıcısıyla köy durumuna işler. Sayfa tanınmazsa false
+  bool absorbActionResponse(int villageId, const QString &pageName,
+                            const QString &html, qint64 timeBaseMs);
+  // Askeri bina slotunun sayfa adı (barracks/stable/workshop), değilse boş
+  QString militaryPageName(int villageId, int slotId) const;
+
   // Connection stability helpers
   void refreshCookiesFromResponse(QNetworkReply *reply);
   QByteArray decompressGzip(const QByteArray &data);
   bool shouldRetryNetworkError(QNetworkReply::NetworkError error) const;
   void resetNetworkManager();
+  // Yanıttan saat örneği alır; sayfa sürelerinin taban anını döndürür
+  qint64 observeServerTime(QNetworkReply *reply, const QString &html);
 
   // Network
   QNetworkAccessManager *m_networkManager;
@@ -143,8 +252,29 @@ private:
   QList<VillageInfo> m_villages;
   int m_currentVillageIndex;
 
-  // Collected data
-  QVariantMap m_collectedData;
+  // Köy sayfaları (döngüler arasında korunur, atlanan sayfalar eski veriyle
+  // kalır - her sayfada "fetchedAt" ve "generation" alanı bulunur)
+  VillageStore m_villageStore;
+  // Köye bağlı olmayan veriler (villageListWithAttacks, genel sayfalar)
+  QVariantMap m_accountData;
+  // Her sayfa kaydında artan sayaç (oturum boyunca tekdüze)
+  quint64 m_pageGeneration = 0;
+
+  // Hangi sayfaların yeniden çekilmesi gerektiğine karar verir
+  RefreshPlanner m_refreshPlanner;
+
+  // Sunucu saati farkı; işlenen sayfanın süre tabanı (0: yanıt dışında)
+  ServerClock m_serverClock;
+  qint64 m_pageTimeBaseMs = 0;
+
+  // Tam döngü (allDataFetched) ile köy bazlı yenilemeleri ayırt etmek için
+  bool m_fullCycleActive = false;
+  QHash<int, int> m_targetedPending; // villageId -> bekleyen istek sayısı
+
+  // Genel bakış kaynak sekmesinden gelen satırlar, inşaat sekmesi gelene
+  // kadar bekletilir (villageId -> lumber/clay/iron/crop)
+  QMap<int, QVariantMap> m_overviewRows;
+  bool m_troopOverviewEnabled = false;
 
   // Statistics
   int m_totalRequests;
@@ -165,6 +295,42 @@ private:
   static constexpr int MAX_FARM_RETRIES = 3;
   static constexpr int FARM_RETRY_DELAY_MS = 2000;
 
+  // Farm list slot cache: gönderimden önce miting sayfasını çekmemek için
+  // aktif slot ID'leri saklanır (fetchFarmLists ve sayfa çekimlerinde dolar)
+  struct FarmListCacheEntry {
+    int villageId = 0;
+    QJsonArray activeSlotIds;
+    qint64 fetchedAtMs = 0;   // son sayfa çekimi (tam senkronizasyon)
+    qint64 confirmedAtMs = 0; // son sayfa çekimi ya da gönderim yanıtı
+  };
+  QHash<int, FarmListCacheEntry> m_farmListCache; // key: listId
+  static constexpr qint64 FARM_CACHE_TTL_MS = 30 * 60 * 1000;
+  // Gönderim yanıtları önbelleği canlı tutar; sayfa yine de ara sıra çekilir
+  static constexpr qint64 FARM_RESYNC_INTERVAL_MS = 3 * 3600 * 1000;
+  double m_troopSpeed = 1.0;
+
+  // Slot başına yağma verimi (raid_yield.json)
+  RaidYieldStore m_raidYield;
+
+  // Eğitim formu önbelleği: POST yanıtı sayfanın tamamını (form action,
+  // gizli alanlar, checksum) içerir; aynı binada sonraki eğitim GET'siz
+  // gönderilir
+  struct TrainingFormCacheEntry {
+    QString html;
+    qint64 storedAtMs = 0;
+  };
+  QHash<QString, TrainingFormCacheEntry> m_trainingForms; // "villageId_slotId"
+  static constexpr qint64 TRAIN_FORM_TTL_MS = 20 * 60 * 1000;
+
+  // Ön yüklenmiş yükseltme linkleri (inşaat bitiminde anında gönderim)
+  struct UpgradeLinkCacheEntry {
+    QString url;
+    QString buildingName;
+    qint64 fetchedAtMs = 0;
+  };
+  QHash<QString, UpgradeLinkCacheEntry> m_upgradeLinks; // "villageId_slotId"
+  static constexpr qint64 UPGRADE_LINK_TTL_MS = 10 * 60 * 1000;
+
   // Cookie auto-refresh
   QString m_cookieCachePath;
   QDateTime m_lastCookieSaveTime;
@@ -0,0 +1,205 @@
+#include "src/parsers/OverviewParser.h"
+#include "src/parsers/HtmlParser.h"
+#include <QRegularExpression>
+#include <QVariantList>
+
+QMap<int, QString> OverviewParser::villageRows(const QString &html, const QString &tableId)
+{
+    QMap<int, QString> rows;
+
+    QRegularExpression tableRegex("<table[^>]*id=\"" + tableId + "\"[^>]*>([\\s\\S]*?)</table>");
+    QRegularExpressionMatch tableMatch = tableRegex.match(html);
+    if (!tableMatch.hasMatch()) {
+        return rows;
+    }
+
+    // Başlık ve toplam satırlarında köy linki yoktur. Aynı köye ait birden
+    // fazla satır (ör. eğitimdeki birlikler) birleştirilir.
+    QRegularExpression rowRegex("<tr[^>]*>([\\s\\S]*?)</tr>");
+    QRegularExpression idRegex("newdid=(\\d+)");
+
+    QRegularExpressionMatchIterator it = rowRegex.globalMatch(tableMatch.captured(1));
+    while (it.hasNext()) {
+        QString row = it.next().captured(1);
+        QRegularExpressionMatch idMatch = idRegex.match(row);
+        if (idMatch.hasMatch()) {
+            rows[idMatch.captured(1).toInt()] += row;
+        }
+    }
+
+    return rows;
+}
+
+int OverviewParser::cellNumber(const QString &cellHtml)
+{
+    QString text = cellHtml;
+    text.remove(QRegularExpression("<[^>]*>"));
+    text.remove(QRegularExpression("&#x[0-9a-fA-F]+;"));
+    text.remove(QRegularExpression("[^\\d-]"));
+    return text.toInt();
+}
+
+QMap<int, QVariantMap> OverviewParser::parseResources(const QString &html)
+{
+    QMap<int, QVariantMap> result;
+
+    // Travian tablo id'sini "ressources" olarak yazar
+    const QMap<int, QString> rows = villageRows(html, "ressources");
+
+    QRegularExpression cellRegex("<td class=\"(lum|clay|iron|crop)[^\"]*\"[^>]*>([\\s\\S]*?)</td>");
+
+    for (auto it = rows.constBegin(); it != rows.constEnd(); ++it) {
+        QVariantMap resources;
+
+        QRegularExpressionMatchIterator cells = cellRegex.globalMatch(it.value());
+        while (cells.hasNext()) {
+            QRegularExpressionMatch m = cells.next();
+            QString key = m.captured(1) == "lum" ? "lumber" : m.captured(1);
+            // dorf1 ile aynı format: string olarak saklanır
+            resources[key] = QString::number(cellNumber(m.captured(2)));
+        }
+
+        if (resources.size() == 4) {
+            result.insert(it.key(), resources);
+        }
+    }
+
+    return result;
+}
+
+QMap<int, QVariantMap> OverviewParser::parseConstruction(const QString &html)
+{
+    QMap<int, QVariantMap> result;
+
+    const QMap<int, QString> rows = villageRows(html, "overview");
+
+    QRegularExpression cellRegex("<td class=\"bui[^\"]*\"[^>]*>([\\s\\S]*?)</td>");
+    QRegularExpression entryRegex("<img[^>]*class=\"bau\"[^>]*>");
+    QRegularExpression titleRegex("(?:title|alt)=\"([^\"]*)\"");
+    QRegularExpression levelRegex("(?:Seviye|Level)\\s*(\\d+)");
+    QRegularExpression timeRegex("(\\d+:\\d{2}:\\d{2})");
+    QRegularExpression timerValueRegex("class=\"timer\"[^>]*value=\"(\\d+)\"");
+
+    for (auto it = rows.constBegin(); it != rows.constEnd(); ++it) {
+        QRegularExpressionMatch cellMatch = cellRegex.match(it.value());
+        if (!cellMatch.hasMatch()) {
+            continue;
+        }
+
+        QString cell = cellMatch.captured(1);
+        QVariantList queue;
+        bool complete = true;
+
+        // Sayaç span'ları varsa inşaat sırasıyla aynı sırada gelir
+        QList<int> timerValues;
+        QRegularExpressionMatchIterator timers = timerValueRegex.globalMatch(cell);
+        while (timers.hasNext()) {
+            timerValues.append(timers.next().captured(1).toInt());
+        }
+
+        QRegularExpressionMatchIterator entries = entryRegex.globalMatch(cell);
+        while (entries.hasNext()) {
+            QString title = titleRegex.match(entries.next().captured(0)).captured(1);
+            title = HtmlParser::decodeTurkishUnicode(title);
+            title.replace("&lt;", "<").replace("&gt;", ">");
+
+            QVariantMap item;
+            item["buildingName"] = title.section(QRegularExpression("<|\\|\\|"), 0, 0).trimmed();
+            item["level"] = levelRegex.match(title).captured(1);
+
+            QString remaining = timeRegex.match(title).captured(1);
+            if (remaining.isEmpty() && queue.size() < timerValues.size()) {
+                int secs = timerValues[queue.size()];
+                remaining = QString("%1:%2:%3")
+                                .arg(secs / 3600)
+                                .arg((secs % 3600) / 60, 2, 10, QChar('0'))
+                                .arg(secs % 60, 2, 10, QChar('0'));
+            }
+            if (remaining.isEmpty()) {
+                complete = false;
+            }
+            item["remainingTime"] = remaining;
+
+            queue.append(item);
+        }
+
+        QVariantMap construction;
+        construction["constructionQueue"] = queue;
+        construction["complete"] = complete;
+        result.insert(it.key(), construction);
+    }
+
+    return result;
+}
+
+QMap<int, QVariantMap> OverviewParser::parseTroops(const QString &html)
+{
+    QMap<int, QVariantMap> result;
+
+    const QMap<int, QString> rows = villageRows(html, "troops");
+
+    QRegularExpression cellRegex("<td([^>]*)>([\\s\\S]*?)</td>");
+    QRegularExpression unitRegex("class=\"unit u(\\d+)\"");
+    QRegularExpression timerValueRegex("class=\"timer\"[^>]*value=\"(\\d+)\"");
+    QRegularExpression timeRegex("(\\d+):(\\d{2}):(\\d{2})");
+    QRegularExpression countRegex("(\\d+)");
+
+    for (auto it = rows.constBegin(); it != rows.constEnd(); ++it) {
+        QVariantMap troops;
+        QVariantList trainingQueue;
+        int unitIndex = 0;
+
+        QRegularExpressionMatchIterator cells = cellRegex.globalMatch(it.value());
+        while (cells.hasNext()) {
+            QRegularExpressionMatch cell = cells.next();
+            QString attributes = cell.captured(1);
+            QString content = cell.captured(2);
+
+            // Köy adı hücresi
+            if (attributes.contains("vil")) {
+                continue;
+            }
+
+            QRegularExpressionMatch unitMatch = unitRegex.match(content);
+            bool hasTimer = content.contains("class=\"timer\"") ||
+                            timeRegex.match(content).hasMatch();
+
+            // Eğitimdeki birlik: ikon + sayaç
+            if (unitMatch.hasMatch() && hasTimer) {
+                int secs = -1;
+                QRegularExpressionMatch valueMatch = timerValueRegex.match(content);
+                if (valueMatch.hasMatch()) {
+                    secs = valueMatch.captured(1).toInt();
+                } else {
+                    QRegularExpressionMatch t = timeRegex.match(content);
+                    secs = t.captured(1).toInt() * 3600 + t.captured(2).toInt() * 60 +
+                           t.captured(3).toInt();
+                }
+
+                QString text = content;
+                text.remove(QRegularExpression("<[^>]*>"));
+                text.remove(timeRegex);
+
+                QVariantMap item;
+                item["unitId"] = unitMatch.captured(1);
+                item["count"] = countRegex.match(text).captured(1);
+                item["remainingSeconds"] = QString::number(secs);
+                trainingQueue.append(item);
+                continue;
+            }
+
+            // Sıradaki sayı hücresi bir sonraki birliğin adedi
+            if (unitIndex < 11) {
+                unitIndex++;
+                troops["t" + QString::number(unitIndex)] = cellNumber(content);
+            }
+        }
+
+        QVariantMap village;
+        village["troops"] = troops;
+        village["trainingQueue"] = trainingQueue;
+        result.insert(it.key(), village);
+    }
+
+    return result;
+}
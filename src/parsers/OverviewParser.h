@@ -0,0 +1,56 @@
+#ifndef OVERVIEWPARSER_H
+#define OVERVIEWPARSER_H
+
+#include <QMap>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @brief Parser for the account-wide village overview (dorf3.php) tabs
+ *
+ * Every tab is a table with one row per village; rows are keyed by the
+ * village ID taken from the row's "newdid" link.
+ */
+class OverviewParser
+{
+public:
+    /**
+     * @brief Parse the resources tab (dorf3.php?s=2)
+     * @param html Raw HTML content
+     * @return villageId -> {lumber, clay, iron, crop}; empty if the tab is
+     *         not available (e.g. no Plus account)
+     */
+    static QMap<int, QVariantMap> parseResources(const QString &html);
+
+    /**
+     * @brief Parse the building column of the overview tab (dorf3.php)
+     * @param html Raw HTML content
+     * @return villageId -> {constructionQueue, complete}; "complete" is false
+     *         when a running construction had no readable remaining time
+     */
+    static QMap<int, QVariantMap> parseConstruction(const QString &html);
+
+    /**
+     * @brief Parse the troops tab (dorf3.php?s=5)
+     * @param html Raw HTML content
+     * @return villageId -> {troops, trainingQueue}; troops maps the tribe
+     *         relative unit ("t1".."t11", t11 = hero) to its count,
+     *         trainingQueue lists {unitId, count, remainingSeconds} with the
+     *         global unit ID
+     */
+    static QMap<int, QVariantMap> parseTroops(const QString &html);
+
+private:
+    /**
+     * @brief Split a table (found by its id) into rows that link a village
+     * @return villageId -> row HTML
+     */
+    static QMap<int, QString> villageRows(const QString &html, const QString &tableId);
+
+    /**
+     * @brief Strip tags and formatting characters from a numeric cell
+     */
+    static int cellNumber(const QString &cellHtml);
+};
+
+#endif // OVERVIEWPARSER_H
@@ -243,7 +243,11 @@ ApplicationWindow {
 
                             MouseArea {
                                 anchors.fill: parent
-                                onClicked: selectedVillageIndex = index
+                                onClicked: {
+                                    selectedVillageIndex = index
+                                    // Seçilen köy arka plan kuyruğunun önünde yenilenir
+                                    if (modelObj) modelObj.selectVillage(modelData.id)
+                                }
                             }
                         }
                     }
@@ -319,6 +323,49 @@ ApplicationWindow {
                             property var d1: vData() && vData().dorf1 ? vData().dorf1 : ({})
                             property var d2: vData() && vData().dorf2 ? vData().dorf2 : ({})
 
+                            // Son dorf1 verisinden canlı tahmin, istek atmadan her saniye güncellenir
+                            property int resourceTick: 0
+                            property var live: {
+                                var tick = resourceTick
+                                var d = allData
+                                var v = currentVillage()
+                                return (modelObj && v) ? modelObj.projectedResources(v.id) : ({})
+                            }
+                            function liveValue(key) {
+                                if (live[key] !== undefined) return live[key]
+                                return d1[key] || "0"
+                            }
+
+                            // Seçilen köy verisinin tazeliği
+                            property var freshness: {
+                                var tick = resourceTick
+                                var d = allData
+                                var v = currentVillage()
+                                return (modelObj && v) ? modelObj.villageFreshness(v.id) : ({})
+                            }
+                            function freshnessText() {
+                                if (freshness.refreshing) return "Yenileniyor..."
+                                var age = freshness.ageSeconds
+                                if (age === undefined || age < 0) return "Veri yok"
+                                if (age < 60) return "Veri " + age + " sn önce"
+                                return "Veri " + Math.floor(age / 60) + " dk önce"
+                            }
+                            function freshnessColor() {
+                                if (freshness.refreshing) return "#3a7bd5"
+                                var age = freshness.ageSeconds
+                                if (age === undefined || age < 0) return "#666"
+                                if (age < 120) return "#4CAF50"
+                                if (age < 600) return "#FF9800"
+                                return "#ff5555"
+                            }
+
+                            Timer {
+                                interval: 1000
+                                running: true
+                                repeat: true
+                                onTriggered: overviewCol.resourceTick++
+                            }
+
                             // Kaynaklar
                             Rectangle {
                                 Layout.fillWidth: true
@@ -332,7 +379,12 @@ ApplicationWindow {
                                     anchors.margins: 14
                                     spacing: 8
 
-                                    Label { text: "Mevcut Kaynaklar"; color: "white"; font.pixelSize: 15; font.bold: true }
+                                    RowLayout {
+                                        Layout.fillWidth: true
+                                        Label { text: "Mevcut Kaynaklar"; color: "white"; font.pixelSize: 15; font.bold: true }
+                                        Item { Layout.fillWidth: true }
+                                        Label { text: overviewCol.freshnessText(); color: overviewCol.freshnessColor(); font.pixelSize: 12 }
+                                    }
 
                                     GridLayout {
                                         columns: 4
@@ -340,20 +392,25 @@ ApplicationWindow {
                                         columnSpacing: 20
 
                                         Label { text: "Odun:"; color: "#aab" }
-                                        Label { text: overviewCol.d1.lumber || "0"; color: "white" }
+                                        Label { text: overviewCol.liveValue("lumber"); color: "white" }
                                         Label { text: "Tugla:"; color: "#aab" }
-                                        Label { text: overviewCol.d1.clay || "0"; color: "white" }
+                                        Label { text: overviewCol.liveValue("clay"); color: "white" }
 
                                         Label { text: "Demir:"; color: "#aab" }
-                                        Label { text: overviewCol.d1.iron || "0"; color: "white" }
+                                        Label { text: overviewCol.liveValue("iron"); color: "white" }
                                         Label { text: "Tahil:"; color: "#aab" }
-                                        Label { text: overviewCol.d1.crop || "0"; color: "white" }
+                                        Label { text: overviewCol.liveValue("crop"); color: "white" }
                                     }
 
                                     RowLayout {
                                         spacing: 20
                                         Label { text: "Depo: " + (overviewCol.d1.warehouseCapacity || "-"); color: "#888" }
                                         Label { text: "Ambar: " + (overviewCol.d1.granaryCapacity || "-"); color: "#888" }
+                                        Label {
+                                            visible: overviewCol.live.ageSeconds !== undefined
+                                            text: "Tahmin (" + Math.floor((overviewCol.live.ageSeconds || 0) / 60) + " dk önceki veriden)"
+                                            color: "#666"
+                                        }
                                     }
                                 }
                             }
@@ -384,6 +441,79 @@ ApplicationWindow {
                                 }
                             }
 
+                            // Kaynak alani planlayici
+                            Rectangle {
+                                id: fieldPlannerCard
+                                Layout.fillWidth: true
+                                Layout.margins: 12
+                                Layout.topMargin: 0
+                                height: 100
+                                radius: 10
+                                color: "#1f2430"
+
+                                property var planner: modelObj ? modelObj.fieldPlanner : ({})
+                                property var villageCap: {
+                                    var v = currentVillage()
+                                    var caps = planner.villageCaps || ({})
+                                    return (v && caps[String(v.id)] !== undefined) ? caps[String(v.id)] : -1
+                                }
+
+                                ColumnLayout {
+                                    anchors.fill: parent
+                                    anchors.margins: 14
+                                    spacing: 8
+
+                                    RowLayout {
+                                        Layout.fillWidth: true
+                                        Label { text: "Kaynak Alani Planlayici"; color: "white"; font.pixelSize: 15; font.bold: true }
+                                        Item { Layout.fillWidth: true }
+                                        Switch {
+                                            checked: fieldPlannerCard.planner.enabled || false
+                                            onToggled: if (modelObj) modelObj.setFieldPlannerEnabled(checked)
+                                        }
+                                    }
+
+                                    RowLayout {
+                                        spacing: 8
+                                        Label { text: "Bu koy sinir:"; color: "#aab" }
+                                        SpinBox {
+                                            from: 1
+                                            to: 20
+                                            value: fieldPlannerCard.villageCap > 0 ? fieldPlannerCard.villageCap
+                                                                                   : (fieldPlannerCard.planner.defaultCap || 10)
+                                            implicitWidth: 100
+                                            onValueModified: {
+                                                var v = currentVillage()
+                                                if (modelObj && v) modelObj.setFieldLevelCap(v.id, value)
+                                            }
+                                        }
+                                        Label {
+                                            visible: fieldPlannerCard.villageCap > 0
+                                            text: "Varsayilana don"
+                                            color: "#3a7bd5"
+                                            font.pixelSize: 11
+                                            MouseArea {
+                                                anchors.fill: parent
+                                                cursorShape: Qt.PointingHandCursor
+                                                onClicked: {
+                                                    var v = currentVillage()
+                                                    if (modelObj && v) modelObj.setFieldLevelCap(v.id, -1)
+                                                }
+                                            }
+                                        }
+                                        Item { width: 20 }
+                                        Label { text: "Varsayilan:"; color: "#aab" }
+                                        SpinBox {
+                                            from: 1
+                                            to: 20
+                                            value: fieldPlannerCard.planner.defaultCap || 10
+                                            implicitWidth: 100
+                                            onValueModified: if (modelObj) modelObj.setFieldLevelCap(0, value)
+                                        }
+                                    }
+                                }
+                            }
+
                             // Insaat Kuyrugu
                             Rectangle {
                                 Layout.fillWidth: true
@@ -1961,6 +2091,37 @@ ApplicationWindow {
                                                     color: "#66bb6a"
                                                     font.pixelSize: 11
                                                 }
+
+                                                // Target horizon: queue kept this many minutes full (0 = max count)
+                                                RowLayout {
+                                                    Layout.fillWidth: true
+                                                    spacing: 8
+
+                                                    Label {
+                                                        text: "Kuyruk hedefi"
+                                                        color: "#ccc"
+                                                        font.pixelSize: 12
+                                                    }
+
+                                                    SpinBox {
+                                                        from: 0
+                                                        to: 1440
+                                                        stepSize: 15
+                                                        value: modelData.targetHorizonMinutes || 0
+                                                        implicitWidth: 110
+                                                        onValueModified: {
+                                                            if (modelObj) {
+                                                                modelObj.setVillageTroopHorizon(selectedVillage(), modelData.building, value)
+                                                            }
+                                                        }
+                                                    }
+
+                                                    Label {
+                                                        text: "dk (0 = en fazla adet)"
+                                                        color: "#888"
+                                                        font.pixelSize: 11
+                                                    }
+                                                }
                                             }
                                         }
                                     }
@@ -2356,6 +2517,7 @@ ApplicationWindow {
 
         property bool queuePanelOpen: false
         property var queue: modelObj ? modelObj.buildQueue : []
+        property var timeline: modelObj ? modelObj.buildTimeline : []
 
         // Group tasks by villageId
         function groupedQueue() {
@@ -2376,6 +2538,18 @@ ApplicationWindow {
             return result
         }
 
+        // Planlanan ilk adım: "Plan 14:05 → 14:38" (öngörülemiyorsa boş)
+        function plannedText(vid, slotId) {
+            for (var i = 0; i < timeline.length; i++) {
+                var step = timeline[i]
+                if (step.villageId !== vid || step.slotId !== slotId) continue
+                if (step.startAt < 0) return "Plan: kaynak/depo yetersiz"
+                return "Plan " + Qt.formatTime(new Date(step.startAt), "HH:mm")
+                        + " → " + Qt.formatTime(new Date(step.endAt), "HH:mm")
+            }
+            return ""
+        }
+
         function villageNameById(vid) {
             if (!villages) return "Köy " + vid
             for (var i = 0; i < villages.length; i++) {
@@ -2477,7 +2651,7 @@ ApplicationWindow {
 
                                 Rectangle {
                                     width: 260
-                                    height: 60
+                                    height: 70
                                     radius: 6
                                     color: "#2a3142"
 
@@ -2504,6 +2678,13 @@ ApplicationWindow {
                                                 color: "#4CAF50"
                                                 font.pixelSize: 11
                                             }
+
+                                            Label {
+                                                text: queuePanel.plannedText(modelData.villageId, modelData.slotId)
+                                                visible: text !== ""
+                                                color: "#888"
+                                                font.pixelSize: 10
+                                            }
                                         }
 
                                         // Delete button
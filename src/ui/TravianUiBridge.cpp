@@ -1,5 +1,6 @@
 #include "src/ui/TravianUiBridge.h"
 #include "src/managers/BuildQueueManager.h"
+#include "src/managers/DeadlineScheduler.h"
 #include "src/managers/FarmListManager.h"
 #include "src/managers/TroopQueueManager.h"
 #include "src/models/Account.h"
@@ -27,6 +28,7 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
   m_buildQueueManager = new BuildQueueManager(this);
   m_buildQueueManager->loadQueue(
       "/Users/kekinci/Desktop/test/config/build_queue.json");
+  m_fieldPlanner.load("/Users/kekinci/Desktop/test/config/field_planner.json");
 
   // Initialize troop queue manager
   m_troopQueueManager = new TroopQueueManager(this);
@@ -36,6 +38,14 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
   connect(m_troopQueueManager, &TroopQueueManager::configChanged, this,
           &TravianUiBridge::troopConfigsChanged);
 
+  // Otomatik eğitim açıksa kuyruklar birlik genel bakışından takip edilir
+  m_fetcher->setTroopOverviewEnabled(m_troopQueueManager->hasEnabledConfigs());
+  connect(m_troopQueueManager, &TroopQueueManager::configChanged, this,
+          [this]() {
+            m_fetcher->setTroopOverviewEnabled(
+                m_troopQueueManager->hasEnabledConfigs());
+          });
+
   connect(m_troopQueueManager, &TroopQueueManager::timerTick, this,
           [this](int villageId, const QString &building, int remaining) {
             Q_UNUSED(villageId);
@@ -48,10 +58,20 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
   m_farmListManager = new FarmListManager(this);
   m_farmListManager->loadConfig(
       "/Users/kekinci/Desktop/test/config/farm_config.json");
+  // Slot başına yağma geçmişi farm_config.json'ın yanında tutulur
+  m_fetcher->loadRaidYield("/Users/kekinci/Desktop/test/config/raid_yield.json");
 
   connect(m_farmListManager, &FarmListManager::configChanged, this,
           &TravianUiBridge::farmConfigsChanged);
 
+  // Yağma sayaçları hedeflere gidiş-dönüş süresine göre kurulur
+  connect(m_fetcher, &TravianDataFetcher::farmListTimingUpdated,
+          m_farmListManager,
+          [this](int villageId, int listId, int roundTripSeconds) {
+            Q_UNUSED(villageId);
+            m_farmListManager->setListRoundTrip(listId, roundTripSeconds);
+          });
+
   connect(m_farmListManager, &FarmListManager::timerTick, this,
           [this](int listId, int remaining) {
             Q_UNUSED(listId);
@@ -77,8 +97,34 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
   // Initialize account model
   m_account = new Account(this);
 
+  // Köy bazlı olaylar (inşaat bitişi, asker kuyruğu, yağma dönüşü, kaynak
+  // yeterliliği) tüm modlarda sadece o köyün gereken sayfalarını yeniler
+  m_deadlineScheduler = new DeadlineScheduler(this);
+  connect(m_deadlineScheduler, &DeadlineScheduler::villageDue, this,
+          [this](int villageId, int pageMask) {
+            if (!m_isLoggedIn) {
+              return;
+            }
+            qDebug() << "[UI] Deadline reached for village" << villageId
+                     << "- targeted refresh, mask:" << pageMask;
+            m_fetcher->refreshVillage(villageId, pageMask);
+          });
+
+  // Yöneticiler eski veriyle karar vermek yerine köyün sayfalarını ister
+  connect(m_troopQueueManager, &TroopQueueManager::refreshRequested, this,
+          [this](int villageId, int pageMask) {
+            if (m_isLoggedIn) {
+              m_fetcher->refreshVillage(villageId, pageMask);
+            }
+          });
+
+  connect(m_fetcher, &TravianDataFetcher::villageRefreshed, this,
+          &TravianUiBridge::applyVillageRefresh);
+
   connect(m_buildQueueManager, &BuildQueueManager::queueChanged, this,
           &TravianUiBridge::buildQueueChanged);
+  connect(m_buildQueueManager, &BuildQueueManager::timelineChanged, this,
+          &TravianUiBridge::buildTimelineChanged);
   connect(m_buildQueueManager, &BuildQueueManager::taskStarted, this,
           [this](int villageId, int slotId, const QString &buildingName) {
             setStatus(QString("🏗️ Auto: %1 yükseltiliyor (Köy %2, Slot %3)")
@@ -119,7 +165,6 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
   connect(
       m_buildQueueManager, &BuildQueueManager::builderBusy, this,
       [this](int villageId, int remainingSec) {
-        Q_UNUSED(villageId);
         int waitTime = remainingSec + 15; // Wait until finished + 15 sec buffer
         setStatus(
             QString("⏳ İnşaat devam ediyor, %1 saniye sonra tekrar denenecek")
@@ -129,19 +174,22 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
                         .arg(waitTime),
                     "warning");
 
-        // Override next refresh time
-        m_refreshTimer->stop();
-        m_refreshTimer->start(waitTime * 1000);
-        m_nextRefreshIn = waitTime;
-        m_buildQueueScheduledRefresh = true; // Mark that we set custom refresh
-        emit nextRefreshInChanged();
+        // Smart mode: inşaat bitişi köy bazlı deadline ile takip ediliyor
+        if (m_refreshMode == "smart") {
+          return;
+        }
+
+        // Tüm köyleri değil, sadece bu köyün dorf1+dorf2'sini yenile
+        m_deadlineScheduler->schedule(
+            villageId, DeadlineScheduler::ConstructionEnd,
+            QDateTime::currentMSecsSinceEpoch() + qint64(waitTime) * 1000,
+            RefreshPlanner::Dorf1 | RefreshPlanner::Dorf2);
       });
 
   // Insufficient resources - wait random 2-5 minutes
   connect(
       m_buildQueueManager, &BuildQueueManager::insufficientResources, this,
       [this](int villageId, const QString &buildingName) {
-        Q_UNUSED(villageId);
         int waitTime = QRandomGenerator::global()->bounded(120, 301); // 2-5 min
         setStatus(QString("💰 %1 için kaynak yetersiz, %2 saniye bekleniyor")
                       .arg(buildingName)
@@ -152,12 +200,16 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
                 .arg(waitTime),
             "warning");
 
-        // Override next refresh time
-        m_refreshTimer->stop();
-        m_refreshTimer->start(waitTime * 1000);
-        m_nextRefreshIn = waitTime;
-        m_buildQueueScheduledRefresh = true; // Mark that we set custom refresh
-        emit nextRefreshInChanged();
+        // Smart mode: kaynak yeterlilik zamanı köy bazlı hesaplanıyor
+        if (m_refreshMode == "smart") {
+          return;
+        }
+
+        // Kaynaklar dorf1'de: sadece bu köyün dorf1'ini yenile
+        m_deadlineScheduler->schedule(
+            villageId, DeadlineScheduler::ResourcesAffordable,
+            QDateTime::currentMSecsSinceEpoch() + qint64(waitTime) * 1000,
+            RefreshPlanner::Dorf1);
       });
 
   // Initialize timers
@@ -318,19 +370,11 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
                     "success");
         setLoading(false);
 
-        // Reset flag before processing queue
-        m_buildQueueScheduledRefresh = false;
-
-        // Upgrade sonrası flag'i sıfırla
-        if (m_upgradeInProgress) {
-          m_upgradeInProgress = false;
-          qDebug() << "[UI] Upgrade sonrası veri geldi";
-        }
-
         // Process build queue - kuyrukta görev varsa her zaman çalışır
         // NOT: Sonsuz döngü tehlikesi yok çünkü:
-        // 1) upgradeStarted artık anında startFetch çağırmıyor (10 sn bekliyor)
-        // 2) isBuilderFree() inşaat devam ediyorsa yeni upgrade başlatmıyor
+        // 1) upgradeStarted artık tam fetch başlatmıyor (köy bazlı yeniler)
+        // 2) hasFreeBuilderSlot() inşaatçılar doluysa yeni upgrade başlatmıyor
+        syncFieldPlan();
         if (m_buildQueueManager->totalTaskCount() > 0) {
           logActivity(QString("İnşaat kuyruğu işleniyor (%1 görev)")
                           .arg(m_buildQueueManager->totalTaskCount()),
@@ -344,6 +388,18 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
           m_troopQueueManager->processTraining(m_fetcher, allData);
         }
 
+        // Canlı kaynak tahminini gerçek veriyle eşitle (sapma ve boşa
+        // giden üretim loglanır)
+        for (const VillageInfo &vi : v) {
+          reconcileResources(vi.id);
+        }
+        emit projectionDriftChanged();
+
+        // Yaklaşan depo taşmasında harcat
+        for (const VillageInfo &vi : v) {
+          checkOverflow(vi.id);
+        }
+
         // Process farm lists (keep timers running) - her zaman çalışır
         if (!m_farmListManager->getConfiguredLists().isEmpty()) {
           m_farmListManager->processAllFarms(m_fetcher, allData);
@@ -362,30 +418,45 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
           }
         }
 
-        // Start auto-refresh if enabled (but not if build queue already
-        // scheduled)
-        if (m_autoRefreshEnabled && !m_buildQueueScheduledRefresh) {
+        // Smart mode: her köyün kendi deadline'larını planla
+        if (m_refreshMode == "smart") {
+          for (const VillageInfo &vi : v) {
+            scheduleVillageDeadlines(vi.id, vi.data);
+          }
+        }
+
+        // Seçilen köyün sayfaları tam döngüyle gelmiş olabilir
+        for (const VillageInfo &vi : v) {
+          finishFocusRefresh(vi.id, vi.data);
+        }
+
+        // Start auto-refresh if enabled
+        if (m_autoRefreshEnabled) {
           scheduleNextRefresh();
         }
       });
 
   // Upgrade signals
   connect(m_fetcher, &TravianDataFetcher::upgradeStarted, this,
-          [this](int villageId, int slotId, const QString &buildingName) {
-            Q_UNUSED(villageId);
+          [this](int villageId, int slotId, const QString &buildingName,
+                 bool villageUpdated) {
             Q_UNUSED(slotId);
+            m_resourceProjector.markSpent(villageId);
             setStatus("🔨 " + buildingName + " yükseltiliyor...");
             logActivity(buildingName + " yükseltme başlatıldı", "success");
-            // Upgrade sonrası verileri yenile — ama hemen değil, 10 saniye
-            // bekle Bu sayede sonsuz döngü engellenir (anında çağırınca döngü
-            // oluşuyordu)
-            m_upgradeInProgress = true;
-            m_refreshTimer->stop();
-            m_refreshTimer->start(10000); // 10 saniye sonra yenile
-            m_nextRefreshIn = 10;
-            m_countdownTimer->start();
-            emit nextRefreshInChanged();
-            logActivity("10 saniye sonra veri yenilenecek", "info");
+
+            // Yanıt sayfası köy durumuna işlendi (villageRefreshed ile
+            // gelir): takip yenilemesine gerek yok
+            if (villageUpdated) {
+              return;
+            }
+
+            // Yanıt işlenemedi: tam fetch yerine 10 saniye sonra sadece bu
+            // köyün dorf1 sayfasını yenile (anında çağırınca döngü oluşuyordu)
+            m_deadlineScheduler->schedule(
+                villageId, DeadlineScheduler::ConstructionEnd,
+                QDateTime::currentMSecsSinceEpoch() + 10000,
+                RefreshPlanner::Dorf1);
           });
 
   connect(m_fetcher, &TravianDataFetcher::upgradeFailed, this,
@@ -426,12 +497,32 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
 
   connect(
       m_fetcher, &TravianDataFetcher::farmListExecuted, this,
-      [this](int villageId, int listId, bool success, const QString &message) {
+      [this](int villageId, int listId, bool success, const QString &message,
+             const QVariantList &slotResults) {
         if (success) {
-          logActivity(QString("Yağma listesi başlatıldı (Köy %1, Liste %2)")
+          QStringList failedSlots;
+          for (const QVariant &slotResult : slotResults) {
+            QVariantMap result = slotResult.toMap();
+            if (!result["success"].toBool()) {
+              failedSlots << QString("%1 (%2)")
+                                 .arg(result["slotId"].toInt())
+                                 .arg(result["error"].toString());
+            }
+          }
+
+          logActivity(QString("Yağma listesi başlatıldı (Köy %1, Liste %2): "
+                              "%3/%4 hedef")
                           .arg(villageId)
-                          .arg(listId),
+                          .arg(listId)
+                          .arg(slotResults.size() - failedSlots.size())
+                          .arg(slotResults.size()),
                       "success");
+          if (!failedSlots.isEmpty()) {
+            logActivity(QString("Gönderilemeyen hedefler (Liste %1): %2")
+                            .arg(listId)
+                            .arg(failedSlots.join(", ")),
+                        "warning");
+          }
 
           if (m_telegramNotifier) {
             m_telegramNotifier->sendNotification(
@@ -456,11 +547,23 @@ TravianUiBridge::TravianUiBridge(QObject *parent) : QObject(parent) {
         }
       });
 
+  // Yükseltme yanıtı geldi: kuyruk yöneticisi o slotu yeniden gönderebilir.
+  // upgradeStarted villageRefreshed'ten önce gelir
+  connect(m_fetcher, &TravianDataFetcher::upgradeStarted, m_buildQueueManager,
+          &BuildQueueManager::onUpgradeResponse);
+  connect(m_fetcher, &TravianDataFetcher::upgradeFailed, m_buildQueueManager,
+          &BuildQueueManager::onUpgradeResponse);
+
+  // Eğitim sonrası kuyruk sonu: hedef süre modunda sonraki tur buna göre
+  connect(m_fetcher, &TravianDataFetcher::trainingQueueUpdated,
+          m_troopQueueManager, &TroopQueueManager::onTrainingQueueUpdated);
+
   // Troop training results
   connect(m_fetcher, &TravianDataFetcher::troopTrainingResult, this,
           [this](int villageId, bool success, const QString &troopName,
                  int count, const QString &message) {
             if (success) {
+              m_resourceProjector.markSpent(villageId);
               logActivity(QString("Asker eğitimi başlatıldı (Köy %1): %2x %3")
                               .arg(villageId)
                               .arg(count)
@@ -596,6 +699,16 @@ void TravianUiBridge::loadSettings() {
   m_baseUrl =
       settings.value("Server/baseUrl", "https://ts30.x3.europe.travian.com")
           .toString();
+  // Birlik hızı çarpanı (ör. 3x sunucuda 3); yağma dönüş süresi için
+  m_fetcher->setTroopSpeed(settings.value("Server/troopSpeed", 1.0).toDouble());
+
+  // Sunucu hızı (ör. 3x sunucuda 3); inşaat süresi tahmini için
+  m_buildQueueManager->setServerSpeed(
+      settings.value("Server/speed", 1.0).toDouble());
+  m_fieldPlanner.setServerSpeed(settings.value("Server/speed", 1.0).toDouble());
+  // Plus hesabı inşaat kuyruğuna bir bekleyen emir ekler
+  m_buildQueueManager->setPlusAccount(
+      settings.value("Account/plus", false).toBool());
 
   // Telegram settings - Only chatId from settings, bot tokens hardcoded
   QString chatId = settings.value("Telegram/chatId", "").toString().trimmed();
@@ -665,7 +778,14 @@ void TravianUiBridge::startFetch() {
   setLoading(true);
   setStatus("⏳ Veri çekiliyor...");
   logActivity("Köy bilgileri çekiliyor...", "info");
-  m_fetcher->fetchAllVillagesData();
+
+  // Fast mode: genel bakış sayfasıyla tüm hesap, köy sayfaları sadece
+  // gerektiğinde (ilk yükleme her zaman tam çekim)
+  if (m_refreshMode == "fast") {
+    m_fetcher->fetchAccountOverview();
+  } else {
+    m_fetcher->fetchAllVillagesData();
+  }
 }
 
 void TravianUiBridge::upgradeBuilding(int villageId, int slotId) {
@@ -701,6 +821,16 @@ void TravianUiBridge::setRefreshMode(const QString &mode) {
   m_refreshMode = mode;
   emit refreshModeChanged();
 
+  if (mode == "smart") {
+    for (const QVariant &villageVar : m_villages) {
+      QVariantMap village = villageVar.toMap();
+      scheduleVillageDeadlines(village["id"].toInt(),
+                               village["data"].toMap());
+    }
+  } else {
+    m_deadlineScheduler->clear();
+  }
+
   // If auto-refresh is active, reschedule with new mode
   if (m_autoRefreshEnabled) {
     scheduleNextRefresh();
@@ -726,6 +856,25 @@ void TravianUiBridge::onCountdownTimer() {
 
 void TravianUiBridge::scheduleNextRefresh() {
   int intervalMs = getRandomInterval();
+
+  // Taşmadan önce veri tazelensin ki kuyruk/eğitim zamanında harcasın
+  // (smart modda bunu köy bazlı StorageOverflow olayı yapar)
+  if (m_refreshMode != "smart") {
+    int overflowSecs = secondsUntilFirstOverflow();
+    if (overflowSecs >= 0) {
+      // Sabit aralık olmasın: %20'ye kadar erken
+      int capSecs =
+          qMax(MIN_OVERFLOW_REFRESH_SECONDS,
+               overflowSecs - OverflowMonitor::OVERFLOW_LEAD_SECONDS);
+      int capMs = QRandomGenerator::global()->bounded(capSecs * 800,
+                                                      capSecs * 1000 + 1);
+      if (capMs < intervalMs) {
+        qDebug() << "[UI] Refresh interval capped by storage overflow:"
+                 << intervalMs / 1000 << "s ->" << capMs / 1000 << "s";
+        intervalMs = capMs;
+      }
+    }
+  }
   m_nextRefreshIn = intervalMs / 1000; // Convert to seconds
 
   m_refreshTimer->start(intervalMs);
@@ -740,19 +889,9 @@ void TravianUiBridge::scheduleNextRefresh() {
 
 int TravianUiBridge::getRandomInterval() const {
   if (m_refreshMode == "smart") {
-    // Smart mode: Calculate based on construction queue
-    int constructionTimeLeft = getConstructionTimeRemaining();
-    int interval = 0;
-
-    if (constructionTimeLeft > 0) {
-      // If building is in progress, check shortly after completion (add
-      // 10-30sec buffer)
-      int buffer = QRandomGenerator::global()->bounded(10, 31) * 1000;
-      interval = constructionTimeLeft + buffer;
-    } else {
-      // No construction, check every 2-5 minutes
-      interval = QRandomGenerator::global()->bounded(120, 301) * 1000;
-    }
+    // Smart mode: köy bazlı olaylar DeadlineScheduler ile hedefli yenileme
+    // yapar, tam yenileme sadece güvenlik ağı olarak 15-25 dakikada bir
+    int interval = QRandomGenerator::global()->bounded(900, 1501) * 1000;
 
     // Checking if we should cap the interval for troop training
     // If bot mode is "troop" or "mixed" AND we have configured troops
@@ -775,6 +914,9 @@ int TravianUiBridge::getRandomInterval() const {
     }
 
     return interval;
+  } else if (m_refreshMode == "fast") {
+    // Fast mode: 1-2 dakika (her döngü çoğunlukla sadece 2 istek)
+    return QRandomGenerator::global()->bounded(60, 121) * 1000;
   } else if (m_refreshMode == "short") {
     // Short mode: 30-60 seconds (less aggressive than 4-5sec)
     return QRandomGenerator::global()->bounded(30, 61) * 1000;
@@ -784,32 +926,155 @@ int TravianUiBridge::getRandomInterval() const {
   }
 }
 
-int TravianUiBridge::getConstructionTimeRemaining() const {
-  // Parse construction queue from village data to get remaining time
-  for (const QVariant &villageVar : m_villages) {
-    QVariantMap village = villageVar.toMap();
-    QVariantMap villageData = village["data"].toMap();
-    QVariantMap dorf1 = villageData["dorf1"].toMap();
-    QVariantList constructionQueue = dorf1["constructionQueue"].toList();
-
-    if (!constructionQueue.isEmpty()) {
-      // Get first construction item
-      QVariantMap construction = constructionQueue.first().toMap();
-      QString remainingTime = construction["remainingTime"].toString();
-
-      // Parse time format "HH:MM:SS"
-      QStringList parts = remainingTime.split(":");
-      if (parts.size() == 3) {
-        int hours = parts[0].toInt();
-        int minutes = parts[1].toInt();
-        int seconds = parts[2].toInt();
-        int totalSeconds = hours * 3600 + minutes * 60 + seconds;
-        return totalSeconds * 1000; // Convert to milliseconds
+void TravianUiBridge::scheduleVillageDeadlines(int villageId,
+                                               const QVariantMap &villageData) {
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  QVariantMap dorf1 = villageData["dorf1"].toMap();
+  qint64 dorf1FetchedAt = dorf1.value("fetchedAt", now).toLongLong();
+
+  // Sayfalar sunucuda güncellensin diye 10-30 sn pay
+  auto buffer = []() {
+    return QRandomGenerator::global()->bounded(10, 31) * 1000LL;
+  };
+
+  // 1) İnşaat bitişi -> dorf1 + dorf2
+  int constructionSecs = -1;
+  const QVariantList constructionQueue = dorf1["constructionQueue"].toList();
+  for (const QVariant &item : constructionQueue) {
+    int secs = RefreshPlanner::parseDuration(
+        item.toMap()["remainingTime"].toString());
+    if (secs >= 0 && (constructionSecs < 0 || secs < constructionSecs)) {
+      constructionSecs = secs;
+    }
+  }
+  if (constructionSecs >= 0) {
+    m_deadlineScheduler->schedule(
+        villageId, DeadlineScheduler::ConstructionEnd,
+        dorf1FetchedAt + constructionSecs * 1000LL + buffer(),
+        RefreshPlanner::Dorf1 | RefreshPlanner::Dorf2);
+  } else {
+    m_deadlineScheduler->cancel(villageId, DeadlineScheduler::ConstructionEnd);
+  }
+
+  // 2) Asker kuyruğu bitişi -> ilgili askeri bina sayfası
+  qint64 troopQueueEnd = 0;
+  int troopMask = 0;
+  const QList<TroopQueueManager::TroopConfig> troopConfigs =
+      m_troopQueueManager->getVillageTroops(villageId);
+  for (const TroopQueueManager::TroopConfig &config : troopConfigs) {
+    if (!config.enabled) {
+      continue;
+    }
+    QVariantMap page = villageData[config.building].toMap();
+    QVariantList trainingQueue = page["trainingQueue"].toList();
+    if (trainingQueue.isEmpty()) {
+      continue;
+    }
+    // Satırlar kümülatif: son satır kuyruğun bitişi
+    qint64 end = page.value("fetchedAt", now).toLongLong() +
+                 trainingQueue.last().toMap()["remainingSeconds"].toLongLong() *
+                     1000;
+    if (troopQueueEnd == 0 || end < troopQueueEnd) {
+      troopQueueEnd = end;
+    }
+    troopMask |= RefreshPlanner::pageFromName(config.building);
+  }
+  if (troopQueueEnd > 0) {
+    m_deadlineScheduler->schedule(villageId, DeadlineScheduler::TroopQueueEnd,
+                                  troopQueueEnd + buffer(), troopMask);
+  } else {
+    m_deadlineScheduler->cancel(villageId, DeadlineScheduler::TroopQueueEnd);
+  }
+
+  // 3) Yağma dönüşü -> dorf1 (ganimet kaynaklara eklenir). Dönen birlikler
+  // dorf1 hareket tablosunda gelen birlik (d1) olarak görünür.
+  int returnSecs = -1;
+  if (m_farmListManager->getConfiguredVillages().contains(villageId)) {
+    const QVariantList movements = dorf1["troopMovements"].toList();
+    for (const QVariant &movement : movements) {
+      QVariantMap m = movement.toMap();
+      if (m["movementClass"].toString() != "d1") {
+        continue;
+      }
+      int secs = RefreshPlanner::parseDuration(m["remainingTime"].toString());
+      if (secs >= 0 && (returnSecs < 0 || secs < returnSecs)) {
+        returnSecs = secs;
       }
     }
   }
+  if (returnSecs >= 0) {
+    m_deadlineScheduler->schedule(villageId, DeadlineScheduler::FarmReturn,
+                                  dorf1FetchedAt + returnSecs * 1000LL +
+                                      buffer(),
+                                  RefreshPlanner::Dorf1);
+  } else {
+    m_deadlineScheduler->cancel(villageId, DeadlineScheduler::FarmReturn);
+  }
+
+  // 4) Kaynak yeterliliği -> dorf1 (sadece inşaatçı boşken anlamlı)
+  int affordableSecs = -1;
+  if (constructionSecs < 0) {
+    affordableSecs = m_buildQueueManager->secondsUntilNextTaskAffordable(
+        villageId, villageData);
+  }
+  if (affordableSecs > 0) {
+    m_deadlineScheduler->schedule(
+        villageId, DeadlineScheduler::ResourcesAffordable,
+        now + affordableSecs * 1000LL + buffer(), RefreshPlanner::Dorf1);
+  } else {
+    m_deadlineScheduler->cancel(villageId,
+                                DeadlineScheduler::ResourcesAffordable);
+  }
+
+  // 5) Depo/ambar taşması -> dorf1, taşmadan önce harcanabilsin diye erken
+  int overflowSecs = m_overflowMonitor.secondsUntilOverflow(
+      m_resourceProjector.snapshot(villageId), now);
+  if (overflowSecs > OverflowMonitor::OVERFLOW_LEAD_SECONDS) {
+    m_deadlineScheduler->schedule(
+        villageId, DeadlineScheduler::StorageOverflow,
+        now + (overflowSecs - OverflowMonitor::OVERFLOW_LEAD_SECONDS) * 1000LL,
+        RefreshPlanner::Dorf1);
+  } else {
+    // Zaten eşikte: checkOverflow harcatır, tekrar tekrar yenilemenin anlamı
+    // yok
+    m_deadlineScheduler->cancel(villageId, DeadlineScheduler::StorageOverflow);
+  }
+}
+
+void TravianUiBridge::applyVillageRefresh(int villageId,
+                                          const QVariantMap &villageData) {
+  m_allData[QString("village_%1").arg(villageId)] = villageData;
+  emit allDataChanged();
+
+  for (int i = 0; i < m_villages.size(); ++i) {
+    QVariantMap one = m_villages[i].toMap();
+    if (one["id"].toInt() == villageId) {
+      one["data"] = villageData;
+      m_villages[i] = one;
+      break;
+    }
+  }
+  emit villagesChanged();
+
+  m_troopQueueManager->updateVillageData(villageId, villageData);
+  reconcileResources(villageId);
+  emit projectionDriftChanged();
+
+  syncFieldPlan();
+  if (!m_buildQueueManager->getQueue(villageId).isEmpty()) {
+    m_buildQueueManager->processVillage(m_fetcher, villageId, villageData);
+  }
+  checkOverflow(villageId);
+
+  if (m_refreshMode == "smart") {
+    scheduleVillageDeadlines(villageId, villageData);
+  }
 
-  return 0; // No construction in progress
+  finishFocusRefresh(villageId, villageData);
+  // Yenileme hatayla bittiyse de bekleme durumu kalkar
+  if (villageId == m_focusVillageId) {
+    m_focusRequestedAtMs = 0;
+  }
 }
 
 // Build queue methods
@@ -832,6 +1097,10 @@ QVariantList TravianUiBridge::buildQueue() const {
   return result;
 }
 
+QVariantList TravianUiBridge::buildTimeline() const {
+  return m_buildQueueManager->timeline();
+}
+
 void TravianUiBridge::addToBuildQueue(int villageId, int slotId,
                                       int targetLevel,
                                       const QString &buildingName) {
@@ -905,6 +1174,8 @@ void TravianUiBridge::setFarmListConfig(int listId, int villageId,
                                         int intervalMinutes) {
   m_farmListManager->setListConfig(listId, villageId, listName,
                                    intervalMinutes);
+  // Liste oyunda düzenlenmiş olabilir - ilk gönderimde slotları yeniden oku
+  m_fetcher->invalidateFarmListCache(listId);
   logActivity(QString("Yağma listesi ayarlandı: %1 (Liste %2, %3 dk)")
                   .arg(listName)
                   .arg(listId)
@@ -914,6 +1185,7 @@ void TravianUiBridge::setFarmListConfig(int listId, int villageId,
 
 void TravianUiBridge::removeFarmListConfig(int listId) {
   m_farmListManager->removeListConfig(listId);
+  m_fetcher->invalidateFarmListCache(listId);
   logActivity(QString("Yağma listesi ayarı kaldırıldı (Liste %1)").arg(listId),
               "info");
 }
@@ -966,9 +1238,23 @@ void TravianUiBridge::setCurrentVillageId(int villageId) {
 void TravianUiBridge::selectVillage(int villageId) {
   setCurrentVillageId(villageId);
 
-  // Trigger data refresh for selected village
-  if (m_isLoggedIn) {
+  if (!m_isLoggedIn) {
+    return;
+  }
+
+  // Tıklama-veri süresi ölçülür; köy verisi gelince finishFocusRefresh
+  m_focusVillageId = villageId;
+  m_focusRequestedAtMs = QDateTime::currentMSecsSinceEpoch();
+
+  // Köyler biliniyorsa sadece seçilen köyü, arka plan kuyruğunun önünde
+  // yenile; tüm hesabı değil
+  if (m_villages.isEmpty()) {
     startFetch();
+  } else if (!m_fetcher->refreshVillage(
+                 villageId, RefreshPlanner::Dorf1 | RefreshPlanner::Dorf2,
+                 true)) {
+    // Gelecek veri yok; genel bakış "Yenileniyor..." da kalmasın
+    m_focusRequestedAtMs = 0;
   }
 }
 
@@ -1051,6 +1337,93 @@ void TravianUiBridge::removeVillageTroop(int villageId,
               "info");
 }
 
+void TravianUiBridge::setVillageTroopHorizon(int villageId,
+                                             const QString &building,
+                                             int targetHorizonMinutes) {
+  m_troopQueueManager->setVillageTroopHorizon(villageId, building,
+                                              targetHorizonMinutes);
+  logActivity(QString("Köy %1 asker kuyruğu hedefi (%2): %3")
+                  .arg(villageId)
+                  .arg(building)
+                  .arg(targetHorizonMinutes > 0
+                           ? QString("%1 dakika").arg(targetHorizonMinutes)
+                           : QString("en fazla adet")),
+              "info");
+}
+
+QVariantMap TravianUiBridge::fieldPlanner() const {
+  QVariantMap villageCaps;
+  const QMap<int, int> caps = m_fieldPlanner.villageCaps();
+  for (auto it = caps.constBegin(); it != caps.constEnd(); ++it) {
+    villageCaps[QString::number(it.key())] = it.value();
+  }
+
+  QVariantMap result;
+  result["enabled"] = m_fieldPlanner.isEnabled();
+  result["defaultCap"] = m_fieldPlanner.defaultCap();
+  result["villageCaps"] = villageCaps;
+  return result;
+}
+
+void TravianUiBridge::setFieldPlannerEnabled(bool enabled) {
+  m_fieldPlanner.setEnabled(enabled);
+  emit fieldPlannerChanged();
+  syncFieldPlan();
+  logActivity(QString("Otomatik kaynak alanı planlayıcı %1")
+                  .arg(enabled ? "aktif" : "pasif"),
+              "info");
+}
+
+void TravianUiBridge::setFieldLevelCap(int villageId, int cap) {
+  if (villageId <= 0) {
+    m_fieldPlanner.setDefaultCap(cap);
+    logActivity(QString("Kaynak alanı varsayılan seviye sınırı: %1").arg(cap),
+                "info");
+  } else {
+    m_fieldPlanner.setVillageCap(villageId, cap);
+    logActivity(QString("Köy %1 kaynak alanı seviye sınırı: %2")
+                    .arg(villageId)
+                    .arg(cap < 0 ? QString("varsayılan") : QString::number(cap)),
+                "info");
+  }
+  emit fieldPlannerChanged();
+  syncFieldPlan();
+}
+
+void TravianUiBridge::syncFieldPlan() {
+  // Kapalıyken de çalışır: önceki otomatik görevleri temizler
+  const QMap<int, QList<FieldPlanner::Candidate>> selected =
+      m_fieldPlanner.selectTasks(m_allData);
+
+  for (auto it = m_allData.constBegin(); it != m_allData.constEnd(); ++it) {
+    if (!it.key().startsWith("village_")) {
+      continue;
+    }
+    int villageId = it.key().mid(8).toInt();
+    QVariantMap villageData = it.value().toMap();
+    const QVariantList resourceFields =
+        villageData["dorf1"].toMap()["resourceFields"].toList();
+
+    QList<BuildQueueManager::BuildTask> tasks;
+    for (const FieldPlanner::Candidate &candidate : selected.value(villageId)) {
+      BuildQueueManager::BuildTask task;
+      task.villageId = villageId;
+      task.slotId = candidate.slotId;
+      task.currentLevel = candidate.level - 1;
+      task.targetLevel = candidate.level;
+      task.priority = 0;
+      for (const QVariant &field : resourceFields) {
+        QVariantMap fieldMap = field.toMap();
+        if (fieldMap["slotId"].toInt() == candidate.slotId) {
+          task.buildingName = fieldMap["name"].toString().trimmed();
+        }
+      }
+      tasks.append(task);
+    }
+    m_buildQueueManager->replaceAutoTasks(villageId, tasks);
+  }
+}
+
 void TravianUiBridge::setVillageTroopEnabled(int villageId,
                                              const QString &building,
                                              bool enabled) {
@@ -1061,3 +1434,116 @@ void TravianUiBridge::setVillageTroopEnabled(int villageId,
                   .arg(building),
               "info");
 }
+
+void TravianUiBridge::reconcileResources(int villageId) {
+  // Taşma izleyicisi kendi kopyasını tutmaz: önceki ve yeni görüntü
+  // projektörden
+  ResourceSnapshot previous = m_resourceProjector.snapshot(villageId);
+  m_resourceProjector.reconcile(villageId,
+                                m_fetcher->villageStore().resources(villageId));
+
+  qint64 wastedBefore = m_overflowMonitor.wastedForVillage(villageId);
+  m_overflowMonitor.update(villageId, previous,
+                           m_resourceProjector.snapshot(villageId));
+  qint64 wasted = m_overflowMonitor.wastedForVillage(villageId) - wastedBefore;
+  if (wasted > 0) {
+    logActivity(QString("Köy %1: depo dolu kaldığı için ~%2 kaynak boşa gitti")
+                    .arg(villageId)
+                    .arg(wasted),
+                "warning");
+    emit wastedProductionChanged();
+  }
+}
+
+void TravianUiBridge::checkOverflow(int villageId) {
+  ResourceSnapshot snapshot = m_resourceProjector.snapshot(villageId);
+
+  // İnşaat kuyruğu processVillage/processQueue ile zaten ilk uygun görevi
+  // başlattı; burada kalan kaynağı asker eğitimine yönlendir
+  int resource = -1;
+  int overflowSecs = m_overflowMonitor.secondsUntilOverflow(
+      snapshot, QDateTime::currentMSecsSinceEpoch(), &resource);
+  if (overflowSecs >= 0 &&
+      overflowSecs <= OverflowMonitor::OVERFLOW_LEAD_SECONDS) {
+    qDebug() << "[UI] Village" << villageId << "resource" << resource
+             << "overflows in" << overflowSecs << "s";
+    m_troopQueueManager->trainSoon(villageId);
+  }
+}
+
+QVariantMap TravianUiBridge::projectedResources(int villageId) const {
+  return m_resourceProjector.projected(villageId,
+                                       QDateTime::currentMSecsSinceEpoch());
+}
+
+QVariantMap TravianUiBridge::villageFreshness(int villageId) const {
+  // Yanında gösterilen kaynaklar dorf1'den; taze bina sayfası eski stoğu
+  // taze göstermesin (finishFocusRefresh de dorf1'e bakar)
+  qint64 fetchedAt =
+      m_fetcher->villageStore().pageFetchedAtMs(villageId, "dorf1");
+
+  QVariantMap result;
+  result["ageSeconds"] =
+      fetchedAt > 0
+          ? qMax<qint64>(0, QDateTime::currentMSecsSinceEpoch() - fetchedAt) /
+                1000
+          : -1;
+  result["refreshing"] =
+      m_focusRequestedAtMs > 0 && m_focusVillageId == villageId;
+  return result;
+}
+
+QVariantMap TravianUiBridge::focusLatency() const {
+  QVariantMap result;
+  result["lastMs"] = m_focusLatencyLastMs;
+  result["meanMs"] =
+      m_focusSamples > 0 ? m_focusLatencySumMs / m_focusSamples : 0;
+  result["maxMs"] = m_focusLatencyMaxMs;
+  result["samples"] = m_focusSamples;
+  return result;
+}
+
+void TravianUiBridge::finishFocusRefresh(int villageId,
+                                         const QVariantMap &villageData) {
+  if (m_focusRequestedAtMs <= 0 || villageId != m_focusVillageId) {
+    return;
+  }
+
+  // Tıklamadan önce çekilmiş sayfa taze sayılmaz (sunucu saati hizası
+  // için 1 sn pay)
+  qint64 dorf1FetchedAt =
+      villageData.value("dorf1").toMap().value("fetchedAt").toLongLong();
+  if (dorf1FetchedAt + 1000 < m_focusRequestedAtMs) {
+    return;
+  }
+
+  qint64 latency = QDateTime::currentMSecsSinceEpoch() - m_focusRequestedAtMs;
+  m_focusRequestedAtMs = 0;
+  m_focusSamples++;
+  m_focusLatencySumMs += latency;
+  m_focusLatencyMaxMs = qMax(m_focusLatencyMaxMs, latency);
+  m_focusLatencyLastMs = latency;
+
+  qDebug() << "[FOCUS] Village" << villageId << "fresh after" << latency
+           << "ms (mean" << m_focusLatencySumMs / m_focusSamples << "ms over"
+           << m_focusSamples << "selections)";
+  emit focusLatencyChanged();
+}
+
+int TravianUiBridge::secondsUntilFirstOverflow() const {
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  int earliest = -1;
+  for (const QVariant &village : m_villages) {
+    int secs = m_overflowMonitor.secondsUntilOverflow(
+        m_resourceProjector.snapshot(village.toMap()["id"].toInt()), now);
+    // Zaten eşikteki köy için harcama checkOverflow ile tetiklendi; dolu
+    // kaldığı sürece aralığı kısaltıp tekrar tekrar yenilemesin
+    if (secs <= OverflowMonitor::OVERFLOW_LEAD_SECONDS) {
+      continue;
+    }
+    if (earliest < 0 || secs < earliest) {
+      earliest = secs;
+    }
+  }
+  return earliest;
+}
@@ -4,12 +4,16 @@
 #include <QVariantList>
 #include <QVariantMap>
 
+#include "src/managers/FieldPlanner.h"
+#include "src/managers/OverflowMonitor.h"
+#include "src/models/ResourceProjector.h"
 #include "src/network/telegramnotifier.h"
 
 class TravianDataFetcher;
 class BuildQueueManager;
 class TroopQueueManager;
 class FarmListManager;
+class DeadlineScheduler;
 class Account;
 
 class TravianUiBridge : public QObject {
@@ -25,6 +29,8 @@ class TravianUiBridge : public QObject {
                  refreshModeChanged)
   Q_PROPERTY(int nextRefreshIn READ nextRefreshIn NOTIFY nextRefreshInChanged)
   Q_PROPERTY(QVariantList buildQueue READ buildQueue NOTIFY buildQueueChanged)
+  Q_PROPERTY(QVariantList buildTimeline READ buildTimeline NOTIFY
+                 buildTimelineChanged)
   Q_PROPERTY(
       QVariantList farmConfigs READ farmConfigs NOTIFY farmConfigsChanged)
   Q_PROPERTY(QVariantList availableFarmLists READ availableFarmLists NOTIFY
@@ -40,6 +46,14 @@ class TravianUiBridge : public QObject {
       QVariantList troopConfigs READ troopConfigs NOTIFY troopConfigsChanged)
   Q_PROPERTY(
       QVariantMap attackDetails READ attackDetails NOTIFY attackDetailsChanged)
+  Q_PROPERTY(QVariantMap wastedProduction READ wastedProduction NOTIFY
+                 wastedProductionChanged)
+  Q_PROPERTY(QVariantMap projectionDrift READ projectionDrift NOTIFY
+                 projectionDriftChanged)
+  Q_PROPERTY(
+      QVariantMap focusLatency READ focusLatency NOTIFY focusLatencyChanged)
+  Q_PROPERTY(
+      QVariantMap fieldPlanner READ fieldPlanner NOTIFY fieldPlannerChanged)
 
 public:
   explicit TravianUiBridge(QObject *parent = nullptr);
@@ -55,6 +69,7 @@ public:
   QString refreshMode() const { return m_refreshMode; }
   int nextRefreshIn() const { return m_nextRefreshIn; }
   QVariantList buildQueue() const;
+  QVariantList buildTimeline() const;
   QVariantList farmConfigs() const;
   QVariantList availableFarmLists() const { return m_availableFarmLists; }
 
@@ -93,6 +108,17 @@ public:
   Q_INVOKABLE void removeVillageTroop(int villageId, const QString &building);
   Q_INVOKABLE void
   setVillageTroopEnabled(int villageId, const QString &building, bool enabled);
+  // 0 = her aralıkta en fazla adet; > 0 = kuyruğu bu kadar dakika dolu tut
+  Q_INVOKABLE void setVillageTroopHorizon(int villageId,
+                                          const QString &building,
+                                          int targetHorizonMinutes);
+
+  // Kaynak alanı otomatik planlayıcı (geri ödeme süresine göre)
+  // {"enabled", "defaultCap", "villageCaps": {id: cap}}
+  QVariantMap fieldPlanner() const;
+  Q_INVOKABLE void setFieldPlannerEnabled(bool enabled);
+  // villageId <= 0: varsayılan sınır; cap < 0: köyü varsayılana döndür
+  Q_INVOKABLE void setFieldLevelCap(int villageId, int cap);
 
   // Activity log
   QVariantList activityLog() const { return m_activityLog; }
@@ -103,6 +129,22 @@ public:
   // Attack details
   QVariantMap attackDetails() const { return m_attackDetails; }
 
+  // Depo/ambar dolu kaldığı için kaybedilen üretim (KPI)
+  QVariantMap wastedProduction() const { return m_overflowMonitor.kpi(); }
+
+  // Son dorf1 verisinden şu ana taşınan kaynak tahmini (istek atmadan)
+  Q_INVOKABLE QVariantMap projectedResources(int villageId) const;
+  QVariantMap projectionDrift() const {
+    return m_resourceProjector.driftStats();
+  }
+
+  // Köyün dorf1 verisinin (kaynaklar) yaşı: {"ageSeconds" (-1: veri yok),
+  // "refreshing"}
+  Q_INVOKABLE QVariantMap villageFreshness(int villageId) const;
+  // Köy seçiminden taze veriye kadar geçen süre:
+  // {"lastMs", "meanMs", "maxMs", "samples"}
+  QVariantMap focusLatency() const;
+
 signals:
   void allDataChanged();
   void villagesChanged();
@@ -113,6 +155,7 @@ signals:
   void refreshModeChanged();
   void nextRefreshInChanged();
   void buildQueueChanged();
+  void buildTimelineChanged();
   void farmConfigsChanged();
   void farmTimerTick();
   void troopConfigsChanged();
@@ -122,6 +165,10 @@ signals:
   void activityLogChanged();
   void botModeChanged();
   void attackDetailsChanged();
+  void wastedProductionChanged();
+  void projectionDriftChanged();
+  void focusLatencyChanged();
+  void fieldPlannerChanged();
 
 private:
   void setLoading(bool v);
@@ -135,15 +182,40 @@ private slots:
 private:
   void scheduleNextRefresh();
   int getRandomInterval() const;
-  int getConstructionTimeRemaining() const;
+  void scheduleVillageDeadlines(int villageId, const QVariantMap &villageData);
+  void applyVillageRefresh(int villageId, const QVariantMap &villageData);
+  // FieldPlanner seçimini inşaat kuyruğunun otomatik görevlerine yansıtır
+  void syncFieldPlan();
+  // Kaynak projektörünü köyün dorf1 verisiyle eşitler, boşa giden üretimi
+  // sayar
+  void reconcileResources(int villageId);
+  // Projektörün görüntüsüyle yaklaşan taşmada harcatır
+  void checkOverflow(int villageId);
+  // Taşma ön süresinin dışındaki köyler içinde en yakın taşmaya kalan
+  // saniye (-1: yok)
+  int secondsUntilFirstOverflow() const;
+  // Seçilen köyün taze verisi geldiyse tıklama-veri süresini kaydeder
+  void finishFocusRefresh(int villageId, const QVariantMap &villageData);
 
 private:
   TravianDataFetcher *m_fetcher = nullptr;
   BuildQueueManager *m_buildQueueManager = nullptr;
   TroopQueueManager *m_troopQueueManager = nullptr;
   FarmListManager *m_farmListManager = nullptr;
+  DeadlineScheduler *m_deadlineScheduler = nullptr; // köy bazlı yenileme
+  FieldPlanner m_fieldPlanner;
+  OverflowMonitor m_overflowMonitor;
+  ResourceProjector m_resourceProjector;
   Account *m_account = nullptr;
 
+  // Seçilen köyün öncelikli yenilemesi (0: bekleyen yok)
+  int m_focusVillageId = -1;
+  qint64 m_focusRequestedAtMs = 0;
+  int m_focusSamples = 0;
+  qint64 m_focusLatencySumMs = 0;
+  qint64 m_focusLatencyMaxMs = 0;
+  qint64 m_focusLatencyLastMs = -1;
+
   QVariantMap m_allData;
   QVariantList m_villages;
 
@@ -156,10 +228,10 @@ private:
   QTimer *m_countdownTimer = nullptr;
   QTimer *m_sessionCheckTimer = nullptr;
   bool m_autoRefreshEnabled = true;
-  QString m_refreshMode = "long"; // "short" (4-5s) or "long" (5-10min)
+  QString m_refreshMode = "long"; // "short", "long", "smart" or "fast"
   int m_nextRefreshIn = 0;        // seconds
-  bool m_buildQueueScheduledRefresh =
-      false; // True if build queue set custom refresh
+  // Taşma yüzünden kısaltılan yenileme aralığının alt sınırı
+  static constexpr int MIN_OVERFLOW_REFRESH_SECONDS = 60;
 
   // Farm lists (per-village)
   QVariantList m_availableFarmLists;          // union of all village lists
@@ -176,9 +248,6 @@ private:
   // Farm list auto-fetch flag (only once on startup)
   bool m_farmListsFetched = false;
 
-  // Upgrade in-progress flag (prevents re-processing after upgrade)
-  bool m_upgradeInProgress = false;
-
   // Activity log
   QVariantList m_activityLog;
 